@@ -0,0 +1,84 @@
+// Header for cardinal_spline.cpp
+#pragma once
+#include "platform.h"
+#include "pixel_sink.h"
+#include "lines.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * CardinalSpline - a cardinal spline through a list of points whose Hermite segments are
+ * flattened once and cached. Appending a point re-flattens only the last two segments (the
+ * old end point gets a new tangent), so interactive previews stay cheap for long splines.
+ *
+ * Tangents are C/2 * (p[i+1] - p[i-1]) in floating point. An end point stands in for its
+ * missing neighbour, so every pair of consecutive points is joined, the first and last included.
+ */
+class CardinalSpline {
+public:
+    explicit CardinalSpline(double tension = 1.0) : c(tension) {}
+
+    void assign(const std::vector<double>& points);   // x, y pairs
+    void append(double x, double y);
+    void clear();
+    void setTension(double tension);                  // re-flattens every segment
+
+    double tension() const { return c; }
+    const std::vector<double>& points() const { return pts; }
+    size_t pointCount() const { return pts.size() / 2; }
+    size_t segmentCount() const { return segments.size(); }
+    // Segment i joins point i to point i + 1; its box is right/bottom exclusive
+    const std::vector<POINT>& segment(size_t i) const { return segments[i].polyline; }
+    const RECT& segmentBounds(size_t i) const { return segments[i].bounds; }
+
+    size_t flattened = 0; // segments flattened so far, for measuring
+
+    void Draw(HDC hdc, COLORREF color) const;
+    void Draw(HDC hdc, COLORREF color, const RECT& area) const;
+
+    // Sink-based versions (see pixel_sink.h); the area overload skips segments whose box misses it
+    template <typename Sink>
+    void Draw(Sink& sink, COLORREF color) const;
+    template <typename Sink>
+    void Draw(Sink& sink, COLORREF color, const RECT& area) const;
+
+private:
+    struct Segment {
+        std::vector<POINT> polyline;
+        RECT bounds;
+    };
+
+    void Tangent(size_t i, double& tx, double& ty) const;
+    void Flatten(size_t i);
+
+    template <typename Sink>
+    static void DrawSegment(Sink& sink, const Segment& segment, COLORREF color);
+
+    std::vector<double> pts;
+    double c;
+    std::vector<Segment> segments;
+};
+
+template <typename Sink>
+void CardinalSpline::DrawSegment(Sink& sink, const Segment& segment, COLORREF color) {
+    const std::vector<POINT>& p = segment.polyline;
+    if (p.size() == 1) sink.setPixel(p[0].x, p[0].y, color);
+    for (size_t i = 1; i < p.size(); i++) {
+        Lines::LineBresenhamDDA(sink, p[i - 1].x, p[i - 1].y, p[i].x, p[i].y, color);
+    }
+}
+
+template <typename Sink>
+void CardinalSpline::Draw(Sink& sink, COLORREF color) const {
+    for (const Segment& s : segments) DrawSegment(sink, s, color);
+}
+
+template <typename Sink>
+void CardinalSpline::Draw(Sink& sink, COLORREF color, const RECT& area) const {
+    for (const Segment& s : segments) {
+        if (s.bounds.left < area.right && area.left < s.bounds.right &&
+            s.bounds.top < area.bottom && area.top < s.bounds.bottom) {
+            DrawSegment(sink, s, color);
+        }
+    }
+}
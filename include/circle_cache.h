@@ -0,0 +1,107 @@
+// Header for circle_cache.cpp
+#pragma once
+#include "platform.h"
+#include "pixel_sink.h"
+#include "common.h"
+#include "curves_second_degree.h"
+#include <cstddef>
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+ * CircleCache - LRU cache of circle rasters keyed by (algorithm, radius).
+ * Every CircleAlgorithm draws through Draw8Points, so its pixels are the reflections of those
+ * in the first octant (0 <= x <= y). That octant is recorded once per key, and drawing a
+ * circle replays it around the new center. Entries are evicted least recently used first
+ * once their offsets exceed the memory budget; a circle larger than the whole budget is
+ * drawn directly. Circles outside the sink's bounds are skipped before any lookup.
+ */
+class CircleCache {
+public:
+    static const size_t DEFAULT_BUDGET = 1 << 20; // bytes of cached offsets
+
+    explicit CircleCache(size_t budgetBytes = DEFAULT_BUDGET) : budgetBytes(budgetBytes) {}
+
+    void setBudget(size_t bytes);                  // evicts down to the new budget
+    size_t budget() const { return budgetBytes; }
+    size_t used() const { return usedBytes; }      // bytes of cached offsets
+    size_t size() const { return entries.size(); }
+    void clear();
+
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+
+    // The cache used by LayerRenderer, one per thread
+    static CircleCache& Shared();
+
+    void Draw(HDC hdc, CircleAlgorithm alg, int xc, int yc, int r, COLORREF c);
+
+    // Sink-based version (see pixel_sink.h)
+    template <typename Sink>
+    void Draw(Sink& sink, CircleAlgorithm alg, int xc, int yc, int r, COLORREF c);
+
+    // Runs the algorithm itself, uncached
+    template <typename Sink>
+    static void Rasterize(Sink& sink, CircleAlgorithm alg, int xc, int yc, int r, COLORREF c);
+
+private:
+    typedef std::pair<int, int> Key; // (algorithm, radius)
+    struct Entry {
+        Key key;
+        std::vector<POINT> octant;
+    };
+
+    // The octant for the key, built on a miss; nullptr when it does not fit in the budget
+    const std::vector<POINT>* Octant(CircleAlgorithm alg, int r);
+    void EvictTo(size_t bytes);
+    static size_t Cost(const Entry& e) { return e.octant.size() * sizeof(POINT); }
+
+    size_t budgetBytes;
+    size_t usedBytes = 0;
+    std::list<Entry> entries; // most recently used first
+    std::map<Key, std::list<Entry>::iterator> index;
+};
+
+template <typename Sink>
+void CircleCache::Draw(Sink& sink, CircleAlgorithm alg, int xc, int yc, int r, COLORREF c) {
+    // Off-screen circles are neither rasterized nor cached
+    long long extent = r < 0 ? -(long long)r : r;
+    ClipSink<Sink> view(sink);
+    if (!view.overlaps(xc - extent, yc - extent, xc + extent, yc + extent))
+        return;
+    bool inside = view.covers(xc - extent, yc - extent, xc + extent, yc + extent);
+    // A partly visible midpoint circle walks only its visible arcs, which beats replaying the octant
+    if (!inside && alg == CIRCLE_MIDPOINT) {
+        SecondDegreeCurve::MidpointCircle(sink, xc, yc, r, c);
+        return;
+    }
+    const std::vector<POINT>* octant = Octant(alg, r);
+    if (!octant) {
+        Rasterize(view, alg, xc, yc, r, c);
+        return;
+    }
+    // Octant points have disjoint reflections, so every pixel is written once
+    for (const POINT& p : *octant) {
+        if (inside)
+            SecondDegreeCurve::Draw8Points(sink, xc, yc, p.x, p.y, c);
+        else
+            SecondDegreeCurve::Draw8Points(view, xc, yc, p.x, p.y, c);
+    }
+}
+
+template <typename Sink>
+void CircleCache::Rasterize(Sink& sink, CircleAlgorithm alg, int xc, int yc, int r, COLORREF c) {
+    if (alg == CIRCLE_DIRECT)
+        SecondDegreeCurve::directcircle(sink, xc, yc, r, c);
+    else if (alg == CIRCLE_POLAR)
+        SecondDegreeCurve::DrawCircle(sink, xc, yc, xc + r, yc, c);
+    else if (alg == CIRCLE_ITERATIVE_POLAR)
+        SecondDegreeCurve::itreativepolar(sink, xc, yc, r, c);
+    else if (alg == CIRCLE_MIDPOINT)
+        SecondDegreeCurve::BresenhamCircle(sink, xc, yc, r, c);
+    else if (alg == CIRCLE_MODIFIED_MIDPOINT)
+        SecondDegreeCurve::ModfiedBresenhamcircle(sink, xc, yc, r, c);
+}
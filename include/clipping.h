@@ -1,6 +1,8 @@
 #pragma once
 
-#include <windows.h>
+#include "platform.h"
+#include "pixel_sink.h"
+#include "lines.h"
 #include <vector>
 
 class Clipping {
@@ -16,6 +18,16 @@ class Clipping {
     static POINT intersect(POINT p1, POINT p2, int edge);
     static int computeCode(int x, int y);
 
+    // Sink-based versions (see pixel_sink.h); the HDC overloads forward to these
+    template <typename Sink>
+    static void ClippingPolygon(Sink& sink, const POINT *points, int n, COLORREF color);
+    template <typename Sink>
+    static void ClippingLine(Sink& sink, int x1, int y1, int x2, int y2, COLORREF color);
+    template <typename Sink>
+    static void ClipPointSquare(Sink& sink, int x, int y, COLORREF color);
+    template <typename Sink>
+    static void Clippingpoint(Sink& sink, int x, int y, COLORREF color);
+
     // Dynamic window boundaries (user can set)
     static int CLIP_X_MIN;
     static int CLIP_Y_MIN;
@@ -153,3 +165,86 @@ class Clipping {
     };
 };
 
+template <typename Sink>
+void Clipping::ClippingPolygon(Sink& sink, const POINT* points, int n, COLORREF color) {
+    if (n < 3) return;
+    
+    std::vector<POINT> clipped = SutherlandHodgmanClip(points, n);
+    if (clipped.size() < 3) return;
+
+    // Draw the clipped polygon (closed)
+    for (size_t i = 0; i < clipped.size(); ++i) {
+        const POINT& a = clipped[i];
+        const POINT& b = clipped[(i + 1) % clipped.size()];
+        Lines::LineBresenhamDDA(sink, a.x, a.y, b.x, b.y, color);
+    }
+}
+
+/**
+ * @brief Draws a line with clipping using the Cohen-Sutherland algorithm.
+ * @param sink Render target (see pixel_sink.h).
+ * @param x1 The x-coordinate of the first point.
+ * @param y1 The y-coordinate of the first point.
+ * @param x2 The x-coordinate of the second point.
+ * @param y2 The y-coordinate of the second point.
+ * @param color The color of the line.
+ * This function implements the Cohen-Sutherland line clipping algorithm to draw a line segment within a clipping window.
+ */
+template <typename Sink>
+void Clipping::ClippingLine(Sink& sink, int x1, int y1, int x2, int y2, COLORREF color) {
+    int code1 = computeCode(x1, y1);
+    int code2 = computeCode(x2, y2);
+    bool accept = false;
+    
+    while (true) {
+        if ((code1 | code2) == 0) {
+            // Both endpoints inside
+            accept = true;
+            break;
+        } else if (code1 & code2) {
+            // Both endpoints share an outside zone
+            break;
+        } else {
+            int codeOut = code1 ? code1 : code2;
+            int x, y;
+            
+            if (codeOut & TOP) {
+                x = x1 + (x2 - x1) * (CLIP_Y_MAX - y1) / (y2 - y1);
+                y = CLIP_Y_MAX;
+            } else if (codeOut & BOTTOM) {
+                x = x1 + (x2 - x1) * (CLIP_Y_MIN - y1) / (y2 - y1);
+                y = CLIP_Y_MIN;
+            } else if (codeOut & RIGHT) {
+                y = y1 + (y2 - y1) * (CLIP_X_MAX - x1) / (x2 - x1);
+                x = CLIP_X_MAX;
+            } else { // LEFT
+                y = y1 + (y2 - y1) * (CLIP_X_MIN - x1) / (x2 - x1);
+                x = CLIP_X_MIN;
+            }
+            
+            if (codeOut == code1) {
+                x1 = x; y1 = y; code1 = computeCode(x1, y1);
+            } else {
+                x2 = x; y2 = y; code2 = computeCode(x2, y2);
+            }
+        }
+    }
+    
+    if (accept) {
+        Lines::LineBresenhamDDA(sink, x1, y1, x2, y2, color);
+    }
+}
+
+template <typename Sink>
+void Clipping::ClipPointSquare(Sink& sink, int x, int y, COLORREF color) {
+    if (x >= CLIP_X_MIN && x <= CLIP_X_MAX && y >= CLIP_Y_MIN && y <= CLIP_Y_MAX) {
+        sink.setPixel(x, y, color);
+    }
+}
+
+template <typename Sink>
+void Clipping::Clippingpoint(Sink& sink, int x, int y, COLORREF color) {
+    if (x >= CLIP_X_MIN && x <= CLIP_X_MAX && y >= CLIP_Y_MIN && y <= CLIP_Y_MAX) {
+        sink.setPixel(x, y, color);
+    }
+}
@@ -1,7 +1,7 @@
 // Header for common.cpp
 #pragma once
 
-#include <windows.h>
+#include "platform.h"
 #include <vector>
 #include <cmath>
 #include <map>
@@ -23,19 +23,69 @@ enum CircleAlgorithm {
     CIRCLE_MODIFIED_MIDPOINT = 4
 };
 enum EllipseAlgorithm { ELLIPSE_DIRECT, ELLIPSE_POLAR, ELLIPSE_MIDPOINT };
+enum BezierAlgorithm { BEZIER_FORWARD_DIFFERENCES, BEZIER_FLATTENED };
 enum FillAlgorithm { FILL_RECURSIVE_FLOOD, FILL_NONRECURSIVE_FLOOD, FILL_CONVEX, FILL_NONCONVEX };
+enum FillRule { FILL_RULE_EVEN_ODD, FILL_RULE_NONZERO };
 
 enum ClippingWindowType {
     CLIP_RECTANGLE,
     CLIP_SQUARE
 };
 
+// Fixed-size column vector and square matrix; plain arrays, so products need no heap and unroll
+template <typename T, int N>
+struct Vec {
+    T v[N];
+    constexpr T& operator[](int i) { return v[i]; }
+    constexpr const T& operator[](int i) const { return v[i]; }
+};
+template <typename T, int N>
+struct Mat {
+    T m[N][N];
+};
+typedef Vec<int, 4> Vec4;
+typedef Mat<int, 4> Mat4;
+
+/**
+ * Cubic basis matrices: a curve segment's power-basis coefficients (t^3, t^2, t, 1) are
+ * Basis * G, where G holds the segment's geometry for that basis.
+ */
+struct CurveBasis {
+    // G = (p1, p2, t1, t2)
+    static constexpr Mat4 Hermite = {{{2, -2, 1, 1}, {-3, 3, -2, -1}, {0, 0, 1, 0}, {1, 0, 0, 0}}};
+    // G = (p1, p2, p3, p4)
+    static constexpr Mat4 Bezier = {{{-1, 3, -3, 1}, {3, -6, 3, 0}, {-3, 3, 0, 0}, {1, 0, 0, 0}}};
+    // G = (p0, p1, p2, p3), uniform B-spline between p1 and p2, scaled by 6
+    static constexpr Mat4 BSpline6 = {{{-1, 3, -3, 1}, {3, -6, 3, 0}, {-3, 0, 3, 0}, {1, 4, 1, 0}}};
+
+    // G = (p0, p1, p2, p3), cardinal spline between p1 and p2 with tangents s * (p[i+1] - p[i-1])
+    static constexpr Mat<double, 4> Cardinal(double s) {
+        return {{{-s, 2 - s, s - 2, s}, {2 * s, s - 3, 3 - 2 * s, -s}, {-s, 0, s, 0}, {0, 1, 0, 0}}};
+    }
+};
+
 class Common {
 public:
     static int Round(double x);
+    static long long ISqrt(long long v); // floor(sqrt(v)), exact for any non-negative v
     static COLORREF interpolateColors(COLORREF c1, COLORREF c2, double t);
-    static std::vector<int> matrixMult(std::vector<std::vector<int>> m1, std::vector<int> m2);
+    template <typename T, int N>
+    static constexpr Vec<T, N> matrixMult(const Mat<T, N>& m1, const Vec<T, N>& m2);
     static bool isValidPolygon(const std::vector<POINT>& points);
     static bool IsConvex(const std::vector<POINT>& points);
     static std::map<std::pair<int, int>, COLORREF> drawings;
 };
+
+template <typename T, int N>
+constexpr Vec<T, N> Common::matrixMult(const Mat<T, N>& m1, const Vec<T, N>& m2)
+{
+    Vec<T, N> result = {};
+    for (int i = 0; i < N; ++i)
+    {
+        for (int j = 0; j < N; ++j)
+        {
+            result[i] += m1.m[i][j] * m2[j];
+        }
+    }
+    return result;
+}
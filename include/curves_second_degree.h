@@ -1,6 +1,11 @@
 // Header for curves_second_degree.cpp
 #pragma once
-#include <windows.h>
+#include "platform.h"
+#include "pixel_sink.h"
+#include "common.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <utility>
 
 class SecondDegreeCurve {
@@ -12,4 +17,298 @@ public:
     static void itreativepolar(HDC hdc, int xc, int yc, int r, COLORREF c);
     static void directcircle(HDC hdc, int xc, int yc, int r, COLORREF c);
     static void ModfiedBresenhamcircle(HDC hdc, int xc, int yc, int r, COLORREF c);
+    static std::pair<int, int> MidpointCircle(HDC hdc, int xc, int yc, int r, COLORREF c, bool filled = false);
+
+    // Sink-based versions (see pixel_sink.h); the HDC overloads forward to these
+    template <typename Sink>
+    static void DrawCircle(Sink& sink, int xc, int yc, int x2, int y2, COLORREF c);
+    template <typename Sink>
+    static std::pair<int, int> BresenhamCircle(Sink& sink, int xc, int yc, int r, COLORREF c);
+    template <typename Sink>
+    static void InterpolatedColoredCurve(Sink& sink, int x1, int y1, int x2, int y2, int x3, int y3, COLORREF c1, COLORREF c2);
+    template <typename Sink>
+    static void Draw8Points(Sink& sink, int xc, int yc, int x, int y, COLORREF c);
+    template <typename Sink>
+    static void itreativepolar(Sink& sink, int xc, int yc, int r, COLORREF c);
+    template <typename Sink>
+    static void directcircle(Sink& sink, int xc, int yc, int r, COLORREF c);
+    template <typename Sink>
+    static void ModfiedBresenhamcircle(Sink& sink, int xc, int yc, int r, COLORREF c);
+
+    /**
+     * Integer midpoint circle: the same pixels as the rounded (x+1)^2 + (y-1/2)^2 - r^2 test,
+     * kept as an incremental decision value. Each pixel is written once. In filled mode every
+     * row of the disk is one fillSpan instead. Returns the last octant point, as BresenhamCircle.
+     * Only the arcs inside the sink's bounds are walked: y and the decision value are closed
+     * forms of x, so each visible range is entered directly and the cost follows the visible pixels.
+     * Pass a ClipSink to narrow the area further.
+     */
+    template <typename Sink>
+    static std::pair<int, int> MidpointCircle(Sink& sink, int xc, int yc, int r, COLORREF c, bool filled = false);
+
+private:
+    // Closed forms of the midpoint walk, so drawing can start at any octant point.
+    // y(x) is the largest y with y(y-1) <= r^2 - x^2 (never above r).
+    static int OctantY(int r, int x)
+    {
+        long long k = (long long)r * r - (long long)x * x;
+        long long y = Common::ISqrt(k);
+        if ((y + 1) * y <= k)
+            y++;
+        return (int)(y < r ? y : r);
+    }
+    // The last x of the octant, the largest with x <= y(x)
+    static int OctantEnd(int r)
+    {
+        int lo = 0, hi = r;
+        while (lo < hi)
+        {
+            int m = lo + (hi - lo + 1) / 2;
+            if (m <= OctantY(r, m)) lo = m; else hi = m - 1;
+        }
+        return lo;
+    }
+    static long long MidpointDecision(int r, int x, int y)
+    {
+        return ((long long)y * (y - 1) - (long long)r * r) + (long long)(x + 1) * (x + 1);
+    }
+    // Half width of the disk's row dy: an x row of the octant spans y(dy), a y row its widest x
+    static int RowHalfWidth(int r, int xEnd, int dy)
+    {
+        if (dy <= xEnd)
+            return OctantY(r, dy);
+        return (int)Common::ISqrt((long long)r * r - (long long)dy * dy + dy);
+    }
 };
+
+template <typename Sink>
+void SecondDegreeCurve::Draw8Points(Sink& sink, int xc, int yc, int x, int y, COLORREF c)
+{
+    // On an axis or a diagonal the eight reflections pair up; write each pixel once
+    if (x == 0 || y == 0)
+    {
+        int a = abs(x) + abs(y);
+        if (a == 0)
+        {
+            sink.setPixel(xc, yc, c);
+            return;
+        }
+        sink.setPixel(xc + a, yc, c);
+        sink.setPixel(xc - a, yc, c);
+        sink.setPixel(xc, yc + a, c);
+        sink.setPixel(xc, yc - a, c);
+        return;
+    }
+    if (abs(x) == abs(y))
+    {
+        sink.setPixel(xc + x, yc + x, c);
+        sink.setPixel(xc - x, yc + x, c);
+        sink.setPixel(xc + x, yc - x, c);
+        sink.setPixel(xc - x, yc - x, c);
+        return;
+    }
+    int dx[8] = {x, -x, x, -x, y, -y, y, -y};
+    int dy[8] = {y, y, -y, -y, x, x, -x, -x};
+    for (int i = 0; i < 8; i++)
+    {
+        sink.setPixel(xc + dx[i], yc + dy[i], c);
+    }
+}
+
+template <typename Sink>
+void SecondDegreeCurve::DrawCircle(Sink& sink, int xc, int yc, int x2, int y2, COLORREF c)
+{
+    int r = Common::Round(sqrt(abs((xc - x2) * (xc - x2) + (yc - y2) * (yc - y2))));
+    // y = Round(sqrt(r^2 - x^2)) is the largest y with y(y-1) < r^2 - x^2 (or 0), so it can
+    // follow x down incrementally instead of taking a root per column
+    long long y = r;
+    for (int i = xc; i <= xc + r; i++)
+    {
+        int x = xc - i;
+        long long k = (long long)r * r - (long long)x * x;
+        while (y > 0 && y * (y - 1) >= k)
+            y--;
+        Draw8Points(sink, xc, yc, x, (int)y, c);
+    }
+}
+
+template <typename Sink>
+std::pair<int, int> SecondDegreeCurve::BresenhamCircle(Sink& sink, int xc, int yc, int r, COLORREF c)
+{
+    return MidpointCircle(sink, xc, yc, r, c);
+}
+
+template <typename Sink>
+std::pair<int, int> SecondDegreeCurve::MidpointCircle(Sink& sink, int xc, int yc, int r, COLORREF c, bool filled)
+{
+    if (r < 0)
+    {
+        if (!filled)
+            Draw8Points(sink, xc, yc, 0, r, c);
+        return {0, r};
+    }
+
+    // The last octant point and the step past it, which the incremental loop would stop on
+    int xEnd = OctantEnd(r);
+    int yEnd = OctantY(r, xEnd);
+    std::pair<int, int> last(xEnd, yEnd);
+    if (xEnd < yEnd)
+        last = {xEnd + 1, MidpointDecision(r, xEnd, yEnd) > 0 ? yEnd - 1 : yEnd};
+
+    ClipSink<Sink> view(sink);
+    if (!view.overlaps((long long)xc - r, (long long)yc - r, (long long)xc + r, (long long)yc + r))
+        return last;
+
+    if (filled)
+    {
+        // Only the visible rows; a row's half width comes straight from the octant
+        long long top = std::max<long long>((long long)yc - r, view.bounds().top);
+        long long bottom = std::min<long long>((long long)yc + r, view.bounds().bottom - 1);
+        for (long long row = top; row <= bottom; row++)
+        {
+            int dy = (int)std::llabs(row - yc);
+            int half = RowHalfWidth(r, xEnd, dy);
+            view.fillSpan((int)row, xc - half, xc + half, c);
+        }
+        return last;
+    }
+
+    // Each reflection of the octant shows the points whose x and y offsets both land in the view.
+    // x is monotone along the octant and y(x) never increases, so that is one range of x per
+    // reflection; only the union of those ranges is walked.
+    RECT area = view.bounds();
+    auto offsets = [](long long center, int sign, long long lo, long long hi) {
+        return sign > 0 ? std::make_pair(lo - center, hi - center) : std::make_pair(center - hi, center - lo);
+    };
+    std::pair<long long, long long> ranges[8];
+    int count = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        int sx = (i & 1) ? -1 : 1, sy = (i & 2) ? -1 : 1;
+        bool swapped = (i & 4) != 0;
+        // Octant x lies on the horizontal axis unless the reflection swaps x and y
+        std::pair<long long, long long> ox = swapped ? offsets(yc, sy, area.top, area.bottom - 1) : offsets(xc, sx, area.left, area.right - 1);
+        std::pair<long long, long long> oy = swapped ? offsets(xc, sx, area.left, area.right - 1) : offsets(yc, sy, area.top, area.bottom - 1);
+        long long lo = std::max(ox.first, 0LL), hi = std::min(ox.second, (long long)xEnd);
+        if (lo > hi || oy.first > oy.second)
+            continue;
+        // First x with y(x) <= the largest visible y, last x with y(x) >= the smallest
+        long long a = lo, b = hi + 1;
+        while (a < b)
+        {
+            long long m = (a + b) / 2;
+            if (OctantY(r, (int)m) <= oy.second) b = m; else a = m + 1;
+        }
+        long long first = a;
+        a = lo - 1, b = hi;
+        while (a < b)
+        {
+            long long m = (a + b + 1) / 2;
+            if (OctantY(r, (int)m) >= oy.first) a = m; else b = m - 1;
+        }
+        if (first > a)
+            continue;
+        // Insertion sort; there are at most eight ranges
+        int at = count++;
+        for (; at > 0 && ranges[at - 1] > std::make_pair(first, a); at--)
+            ranges[at] = ranges[at - 1];
+        ranges[at] = {first, a};
+    }
+
+    bool inside = view.covers((long long)xc - r, (long long)yc - r, (long long)xc + r, (long long)yc + r);
+    long long done = -1; // octant points up to here were drawn already
+    for (int i = 0; i < count; i++)
+    {
+        if (ranges[i].second <= done)
+            continue;
+        // Seek straight to the range: y(x) and d are closed forms of x
+        int x = (int)std::max(ranges[i].first, done + 1);
+        int y = OctantY(r, x);
+        long long d = MidpointDecision(r, x, y);
+        for (;;)
+        {
+            if (inside)
+                Draw8Points(sink, xc, yc, x, y, c);
+            else
+                Draw8Points(view, xc, yc, x, y, c);
+            if (x == ranges[i].second)
+                break;
+            // d = (x+1)^2 + y^2 - y - r^2, the rounded midpoint test; y steps down when d > 0
+            bool stepY = d > 0;
+            x++;
+            d += 2LL * x + 1;
+            if (stepY)
+            {
+                y--;
+                d -= 2LL * y;
+            }
+        }
+        done = ranges[i].second;
+    }
+    return last;
+}
+
+template <typename Sink>
+void SecondDegreeCurve::InterpolatedColoredCurve(Sink& sink, int x1, int y1, int x2, int y2, int x3, int y3, COLORREF c1, COLORREF c2) {
+    int alphaX = 2 * x3 + 2 * x1 - 4 * x2;
+    int betaX = 4 * x2 - 3 * x1 - x3;
+    int alphaY = 2 * y3 + 2 * y1 - 4 * y2;
+    int betaY = 4 * y2 - 3 * y1 - y3;
+    double steps = 1.0 / 100000;
+
+    for (double t = 0; t <= 1; t += steps) {
+        COLORREF c = Common::interpolateColors(c1, c2, t);
+        sink.setPixel(Common::Round(alphaX * t * t + betaX * t + x1), Common::Round(alphaY * t * t + betaY * t + y1), c);
+    }
+}
+
+// iterative polar circle
+template <typename Sink>
+void SecondDegreeCurve::itreativepolar(Sink& sink, int xc, int yc, int r, COLORREF c) {
+    double x=r,y=0,dtheta=1.0/r;
+    double ct= cos(dtheta),st=sin(dtheta);
+
+    Draw8Points(sink,xc,yc,Common::Round(x),Common::Round(y),c);
+    while (x>y) {
+        double x1=x*ct-y*st;
+    
+        y=x*st+y*ct;
+        x=x1;
+        Draw8Points(sink,xc,yc,Common::Round(x),Common::Round(y),c);
+    }
+}
+
+template <typename Sink>
+void SecondDegreeCurve::directcircle(Sink& sink, int xc, int yc, int r, COLORREF c) {
+
+    int x=0,y=r;
+
+    Draw8Points(sink, xc, yc, x, y, c);
+    while (y > x) {
+        x++;
+        y=round(sqrt(r * r - x * x));
+        Draw8Points(sink, xc , yc , x, y, c);
+     }
+}
+
+template <typename Sink>
+void SecondDegreeCurve::ModfiedBresenhamcircle(Sink& sink, int xc, int yc, int r, COLORREF c) {
+    int x=0,y=r,d=1-r;
+    int d1=3,d2=5-2*r;
+
+    Draw8Points(sink,xc,yc,x,y,c);
+    while (x<y) {
+        x++;
+        if (d<0) { 
+            d+=d1; 
+            d1+=2;
+            d2+=2;
+        } else {
+            y--;
+            d+=d2;
+            d1+=2;
+            d2+=4;
+        }
+        Draw8Points(sink,xc,yc,x,y,c);
+    }
+}
@@ -1,13 +1,169 @@
 // Header for curves_third_degree.cpp
 #pragma once
-#include <windows.h>
+#include "platform.h"
+#include "pixel_sink.h"
+#include "common.h"
+#include "lines.h"
+#include "cardinal_spline.h"
+#include <algorithm>
+#include <cstdlib>
 #include <vector>
 
 class ThirdDegreeCurve {
 public:
     static void HermiteCurve(HDC hdc, int x1, int y1, int u1, int v1, int x2, int y2, int u2, int v2, COLORREF c);
     static void BezierCurve(HDC hdc, int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4, COLORREF c);
-    static std::vector<double> Bezier(std::vector<double> points, double t);
+    static std::vector<double> Bezier(const std::vector<double>& points, double t);
+    /**
+     * Evaluates a Bezier curve of any degree (x, y pairs) at t[0..count), writing x[i], y[i].
+     * Samples are computed BEZIER_LANES at a time with the Bernstein form in Horner order,
+     * O(degree) per sample, using a per-thread scratch buffer instead of allocating.
+     */
+    static void EvaluateBezier(const std::vector<double>& points, const double* t, size_t count, double* x, double* y);
     static void RecBezier(HDC hdc, std::vector<double> points, COLORREF c);
     static void CardinalSplines(HDC hdc, std::vector<double> points, int C, COLORREF color);
+    static void FlatBezier(HDC hdc, const std::vector<double>& points, COLORREF c, double tolerance = BEZIER_FLATNESS);
+
+    /**
+     * Flattens a Bezier curve of any degree (x, y pairs, as for RecBezier) into a polyline.
+     * The curve is halved until each piece's control hull is within `tolerance` pixels of its
+     * chord. The polyline starts and ends on the curve's end points and can be used for
+     * drawing, bounding boxes and hit tests.
+     */
+    static void FlattenBezier(const std::vector<double>& points, std::vector<POINT>& polyline, double tolerance = BEZIER_FLATNESS);
+
+    // Sink-based versions (see pixel_sink.h); the HDC overloads forward to these
+    template <typename Sink>
+    static void HermiteCurve(Sink& sink, int x1, int y1, int u1, int v1, int x2, int y2, int u2, int v2, COLORREF c);
+    template <typename Sink>
+    static void BezierCurve(Sink& sink, int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4, COLORREF c);
+    template <typename Sink>
+    static void RecBezier(Sink& sink, std::vector<double> points, COLORREF c);
+    template <typename Sink>
+    static void CardinalSplines(Sink& sink, std::vector<double> points, int C, COLORREF color);
+    // Draws the FlattenBezier polyline with the line rasterizer
+    template <typename Sink>
+    static void FlatBezier(Sink& sink, const std::vector<double>& points, COLORREF c, double tolerance = BEZIER_FLATNESS);
+
+    static constexpr double BEZIER_FLATNESS = 0.5;   // default flattening tolerance, in pixels
+    static const int BEZIER_MAX_DEPTH = 16;          // halvings of one curve at most
+    static const int BEZIER_LANES = 8;               // samples evaluated side by side
+
+    // Upper bound on the steps of one cubic, so the fixed-point differences fit in 64 bits
+    static const int CUBIC_MAX_STEPS = 1 << 15;
+
+private:
+    /**
+     * Plots x(t) = cx[0]t^3 + cx[1]t^2 + cx[2]t + cx[3] (and y likewise) for t in [0, 1].
+     * The step count comes from the Bezier control polygon of the cubic, so no step moves
+     * more than one pixel, and each pixel is plotted once per visit.
+     */
+    template <typename Sink>
+    static void DrawCubic(Sink& sink, const int cx[4], const int cy[4], COLORREF c);
+
+    // One coordinate of a cubic advanced by forward differences with t steps of 1/n.
+    // Values are kept exactly, relative to the start point and scaled by n^3.
+    struct CubicStepper {
+        long long f, d1, d2, d3;
+        int start, offset; // the plotted coordinate is start + offset
+
+        CubicStepper(const int k[4], long long n)
+            : f(0), d1(k[0] + k[1] * n + k[2] * n * n), d2(6LL * k[0] + 2LL * k[1] * n), d3(6LL * k[0]), start(k[3]), offset(0) {}
+
+        // Advances t by 1/n; true when the rounded coordinate changed
+        bool step(long long n3) {
+            f += d1;
+            d1 += d2;
+            d2 += d3;
+            // offset = floor(f / n^3 + 1/2), the rounding Common::Round does on screen coordinates
+            bool moved = false;
+            while (2 * f >= (2LL * offset + 1) * n3) { offset++; moved = true; }
+            while (2 * f < (2LL * offset - 1) * n3) { offset--; moved = true; }
+            return moved;
+        }
+        int pixel() const { return start + offset; }
+    };
 };
+
+template <typename Sink>
+void ThirdDegreeCurve::HermiteCurve(Sink& sink, int x1, int y1, int u1, int v1, int x2, int y2, int u2, int v2, COLORREF c) {
+    Vec4 Cx = Common::matrixMult(CurveBasis::Hermite, Vec4{{x1, x2, u1, u2}});
+    Vec4 Cy = Common::matrixMult(CurveBasis::Hermite, Vec4{{y1, y2, v1, v2}});
+    DrawCubic(sink, Cx.v, Cy.v, c);
+}
+
+template <typename Sink>
+void ThirdDegreeCurve::BezierCurve(Sink& sink, int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4, COLORREF c) {
+    Vec4 Cx = Common::matrixMult(CurveBasis::Bezier, Vec4{{x1, x2, x3, x4}});
+    Vec4 Cy = Common::matrixMult(CurveBasis::Bezier, Vec4{{y1, y2, y3, y4}});
+    DrawCubic(sink, Cx.v, Cy.v, c);
+}
+
+template <typename Sink>
+void ThirdDegreeCurve::DrawCubic(Sink& sink, const int cx[4], const int cy[4], COLORREF c) {
+    // Three times the legs of the equivalent Bezier control polygon bound the speed |x'(t)|
+    long long n = 1;
+    for (const int* k : {cx, cy}) {
+        n = std::max({n, std::llabs(k[2]), std::llabs((long long)k[1] + k[2]), std::llabs(3LL * k[0] + 2LL * k[1] + k[2])});
+    }
+    if (n > CUBIC_MAX_STEPS) {
+        // Far larger than any canvas: sample in floating point instead of overflowing
+        int lastX = 0, lastY = 0;
+        for (int i = 0; i <= CUBIC_MAX_STEPS; i++) {
+            double t = (double)i / CUBIC_MAX_STEPS, t2 = t * t, t3 = t2 * t;
+            int x = Common::Round(cx[0] * t3 + cx[1] * t2 + cx[2] * t + cx[3]);
+            int y = Common::Round(cy[0] * t3 + cy[1] * t2 + cy[2] * t + cy[3]);
+            if (i == 0 || x != lastX || y != lastY) sink.setPixel(x, y, c);
+            lastX = x;
+            lastY = y;
+        }
+        return;
+    }
+
+    const long long n3 = n * n * n;
+    CubicStepper x(cx, n), y(cy, n);
+    sink.setPixel(x.pixel(), y.pixel(), c);
+    for (long long i = 0; i < n; i++) {
+        bool movedX = x.step(n3);
+        bool movedY = y.step(n3);
+        if (movedX || movedY) sink.setPixel(x.pixel(), y.pixel(), c);
+    }
+}
+
+template <typename Sink>
+void ThirdDegreeCurve::RecBezier(Sink& sink, std::vector<double> points, COLORREF c) {
+    if (points.size() < 2) return;
+    const int samples = 20000;
+    double t[BEZIER_LANES], x[BEZIER_LANES], y[BEZIER_LANES];
+    int lastX = 0, lastY = 0;
+    for (int first = 0; first < samples; first += BEZIER_LANES) {
+        int count = samples - first < BEZIER_LANES ? samples - first : BEZIER_LANES;
+        for (int i = 0; i < count; i++) t[i] = (first + i) / (double)samples;
+        EvaluateBezier(points, t, count, x, y);
+        for (int i = 0; i < count; i++) {
+            int px = (int)x[i], py = (int)y[i];
+            if (first + i == 0 || px != lastX || py != lastY) sink.setPixel(px, py, c);
+            lastX = px;
+            lastY = py;
+        }
+    }
+}
+
+template <typename Sink>
+void ThirdDegreeCurve::FlatBezier(Sink& sink, const std::vector<double>& points, COLORREF c, double tolerance) {
+    std::vector<POINT> polyline;
+    FlattenBezier(points, polyline, tolerance);
+    if (polyline.size() == 1) sink.setPixel(polyline[0].x, polyline[0].y, c);
+    for (size_t i = 1; i < polyline.size(); i++) {
+        Lines::LineBresenhamDDA(sink, polyline[i - 1].x, polyline[i - 1].y, polyline[i].x, polyline[i].y, c);
+    }
+}
+
+template <typename Sink>
+void ThirdDegreeCurve::CardinalSplines(Sink& sink, std::vector<double> points, int C, COLORREF color)
+{
+    // Callers that add points over time should keep a CardinalSpline, which caches the segments
+    CardinalSpline spline(C);
+    spline.assign(points);
+    spline.Draw(sink, color);
+}
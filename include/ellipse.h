@@ -1,6 +1,12 @@
 #pragma once
-#include <windows.h>
+#include "platform.h"
+#include "pixel_sink.h"
+#include "common.h"
+#include <algorithm>
+#include <climits>
 #include <cmath>
+#include <cstdlib>
+#include <utility>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -10,7 +16,366 @@
 class Ellipse {
 public:
     static void DrawEllipseEquation(HDC hdc, int xc, int yc, int a, int b, COLORREF c);
-    static void DrawEllipseMidPoint(HDC hdc, int xc, int yc, int a, int b, COLORREF c);
+    static void DrawEllipseMidPoint(HDC hdc, int xc, int yc, int a, int b, COLORREF c, bool filled = false);
     static void DrawEllipsePolar(HDC hdc, int xc, int yc, int a, int b, COLORREF c);
-    
+
+    // Sink-based versions (see pixel_sink.h); the HDC overloads forward to these
+    template <typename Sink>
+    static void DrawEllipseEquation(Sink& sink, int xc, int yc, int a, int b, COLORREF c);
+    template <typename Sink>
+    static void DrawEllipseMidPoint(Sink& sink, int xc, int yc, int a, int b, COLORREF c, bool filled = false);
+    template <typename Sink>
+    static void DrawEllipsePolar(Sink& sink, int xc, int yc, int a, int b, COLORREF c);
+
+private:
+    static const int POLAR_RESEED_STEPS = 256; // rotation steps between exact cos/sin evaluations
+
+    // Smallest and largest |v - center| over v in [lo, hi]
+    static void VisibleOffsets(long long lo, long long hi, int center, long long& dMin, long long& dMax) {
+        dMax = std::max(std::llabs(lo - center), std::llabs(hi - center));
+        if (center < lo) dMin = lo - center;
+        else if (center > hi) dMin = center - hi;
+        else dMin = 0;
+    }
+    // Sign of p*q - r*s, exact even when the products do not fit in 64 bits
+    static int CompareProducts(long long p, long long q, long long r, long long s) {
+        long double diff = (long double)p * q - (long double)r * s;
+        if (diff > 1e18L) return 1;
+        if (diff < -1e18L) return -1;
+        // The true difference is then below 2^63, so computing it modulo 2^64 is exact
+        long long exact = (long long)((unsigned long long)p * (unsigned long long)q - (unsigned long long)r * (unsigned long long)s);
+        return (exact > 0) - (exact < 0);
+    }
+
+    // Closed forms of region 1 of the midpoint walk (a, b > 0), so it can start at any x.
+    // Its d at (x, y) is 2 F(x+1, y-1/2) - d0, for F(X, Y) = b^2 X^2 + a^2 Y^2 - a^2 b^2 and d0 the
+    // start value, so y steps down when F(x+1, y-1/2) >= d0/2. y(x) is the smallest y <= b with
+    // F(x, y+1/2) >= d0/2, which times 8 reads a^2 (2 (2y+1)^2 - 8b^2 + 4b - 1) >= 4 b^2 (1 - 2x^2).
+    static long long Region1Y(long long a, long long b, long long x) {
+        long long lo = 0, hi = b;
+        while (lo < hi) {
+            long long m = lo + (hi - lo) / 2;
+            if (CompareProducts(a * a, 2 * (2 * m + 1) * (2 * m + 1) - 8 * b * b + 4 * b - 1, 4 * b * b, 1 - 2 * x * x) >= 0) hi = m;
+            else lo = m + 1;
+        }
+        return lo;
+    }
+    // The last x of region 1, the largest with b^2 x <= a^2 y(x); y(x) > 0 only up to x = a
+    static long long Region1End(long long a, long long b) {
+        long long lo = 0, hi = a;
+        while (lo < hi) {
+            long long m = lo + (hi - lo + 1) / 2;
+            if (b * b * m <= a * a * Region1Y(a, b, m)) lo = m; else hi = m - 1;
+        }
+        return lo;
+    }
+    // The walk's k = floor(2d) at a region 1 point. Its terms nearly cancel, so they are summed
+    // modulo 2^64; the result itself fits, as it is the value the walk would reach.
+    static long long Region1Decision(long long a, long long b, long long x, long long y) {
+        typedef unsigned long long U;
+        U a2 = (U)(a * a), b2 = (U)(b * b);
+        U k = 4 * b2 * (U)(x + 1) * (U)(x + 1) + a2 * (U)(2 * y - 1) * (U)(2 * y - 1) - 4 * a2 * b2 - 2 * b2 + 2 * a2 * (U)b - (U)((a * a + 1) / 2);
+        return (long long)k;
+    }
+    // floor(u^2 / den) for den > 0, where u^2 itself may not fit in 64 bits; exact is set when
+    // den divides u^2. The estimate is corrected with the remainder, computed modulo 2^64.
+    static long long SquareOver(long long u, long long den, bool& exact) {
+        long long q = (long long)((long double)u * u / den);
+        long long rem = (long long)((unsigned long long)u * (unsigned long long)u - (unsigned long long)q * (unsigned long long)den);
+        while (rem < 0) { q--; rem += den; }
+        while (rem >= den) { q++; rem -= den; }
+        exact = rem == 0;
+        return q;
+    }
 };
+
+/**
+ * @brief Draws an ellipse using the midpoint algorithm.
+ * @param sink Render target (see pixel_sink.h).
+ * @param xc X-coordinate of the center of the ellipse.
+ * @param yc Y-coordinate of the center of the ellipse.
+ * @param a Semi-major axis length.
+ * @param b Semi-minor axis length.
+ * @param c Color of the ellipse.
+ * @param filled Fill the ellipse: one fillSpan per row instead of the outline.
+ * This function uses the midpoint algorithm to draw an ellipse by calculating points in the first quadrant and reflecting them to the other quadrants.
+ * The decision values are kept in 64-bit integers with the same signs as the original floating point
+ * recurrence, so the pixels are unchanged and radii up to 1e6 do not overflow. Consecutive pixels
+ * on a row are written as one span per quadrant.
+ * Only pixels inside the sink's bounds are written. Region 1 starts at its first point in the view's
+ * columns and rows, and the walk stops as soon as the rest of the quadrant arc lies outside them.
+ * Region 2 has no closed form to start from (the original recurrence leaves the y term out of its
+ * diagonal steps, so d depends on the path), so its rows above the view are stepped through unwritten.
+ */
+template <typename Sink>
+void Ellipse::DrawEllipseMidPoint(Sink& sink, int xc, int yc, int a, int b, COLORREF c, bool filled) {
+    ClipSink<Sink> view(sink);
+    if (!view.overlaps((long long)xc - a, (long long)yc - b, (long long)xc + a, (long long)yc + b))
+        return;
+    if (a == 0 || b == 0) {
+        // Degenerate: the axis segment
+        for (int y = -b; y <= b; y++)
+            view.fillSpan(yc + y, xc - a, xc + a, c);
+        return;
+    }
+    // |x| only grows and |y| only shrinks along the walk, so the visible part of the quadrant is the
+    // stretch with x and y both in range (a filled row stays visible through its middle, so only y counts)
+    RECT area = view.bounds();
+    long long dxMin, dxMax, dyMin, dyMax;
+    VisibleOffsets(area.left, (long long)area.right - 1, xc, dxMin, dxMax);
+    VisibleOffsets(area.top, (long long)area.bottom - 1, yc, dyMin, dyMax);
+    if (filled) {
+        dxMin = 0;
+        dxMax = LLONG_MAX;
+    }
+
+    // The pixels of one row of the quadrant, x0..x1, written once the walk leaves the row
+    int rowY = -1, x0 = 0, x1 = -1;
+    auto flushRow = [&]() {
+        if (x1 < x0)
+            return;
+        for (int side = 0; side < (rowY == 0 ? 1 : 2); side++) {
+            int y = side == 0 ? yc + rowY : yc - rowY;
+            if (filled || x0 == 0) {
+                view.fillSpan(y, xc - x1, xc + x1, c); // through the middle: one span for both sides
+            } else if (x0 == x1) {
+                view.setPixel(xc + x0, y, c);
+                view.setPixel(xc - x0, y, c);
+            } else {
+                view.fillSpan(y, xc + x0, xc + x1, c);
+                view.fillSpan(y, xc - x1, xc - x0, c);
+            }
+        }
+    };
+    auto plot = [&](int x, int y) {
+        if (y != rowY) {
+            flushRow();
+            rowY = y;
+            x0 = x;
+        }
+        x1 = x;
+    };
+
+    const long long a2 = (long long)a * a, b2 = (long long)b * b;
+    long long x = 0, y = b;
+
+    // Region 1. The original d starts at b^2 - a^2 b + a^2/4 and moves in even integer steps,
+    // so its sign is that of k = floor(2d): k < 0 exactly when d < 0.
+    long long k = 2 * b2 - 2 * a2 * b + a2 / 2;
+    if (a > 0 && b > 0 && (dxMin > 0 || dyMax < b)) {
+        // Seek to the first x with x >= dxMin and y(x) <= dyMax. When region 1 has none, start on its
+        // last point: past it y(x) can fall by more than the single row the walk steps down.
+        long long end = Region1End(a, b), lo = 0, hi = end;
+        while (lo < hi) {
+            long long m = lo + (hi - lo) / 2;
+            if (Region1Y(a, b, m) <= dyMax) hi = m; else lo = m + 1;
+        }
+        x = std::min(std::max(lo, dxMin), end);
+        y = Region1Y(a, b, x);
+        k = Region1Decision(a, b, x, y);
+    }
+    while (b2 * x <= a2 * y) {
+        if (x > dxMax || y < dyMin) {
+            flushRow();
+            return;
+        }
+        plot((int)x, (int)y);
+        if (k < 0) {
+            k += 4 * b2 * (2 * x + 3);
+        } else {
+            // Subtract first: the two terms nearly cancel, and either alone is close to the int64 limit
+            k -= 8 * a2 * (y - 1);
+            k += 4 * b2 * (2 * x + 3);
+            y--;
+        }
+        x++;
+    }
+
+    // Region 2. d = b^2 (x + 1/2)^2 / a^2 + floor(a^2 / 4) - b^2 plus integer steps, so only its
+    // starting value has a fraction; j is the integer part, rounded up when the fraction is not 0,
+    // and j > 0 exactly when d > 0.
+    bool exact;
+    long long j = SquareOver((long long)b * (2 * x + 1), 4 * a2, exact) + a2 / 4 - b2;
+    if (!exact)
+        j++;
+    while (y >= 0) {
+        if (x > dxMax || y < dyMin) {
+            flushRow();
+            return;
+        }
+        plot((int)x, (int)y);
+        if (j > 0) {
+            j -= 4 * a2 * (y - 1);
+        } else {
+            j += 2 * b2 * (2 * x + 3);
+            x++;
+        }
+        y--;
+    }
+    flushRow();
+}
+
+/**
+ * @brief Draws an ellipse using the polar coordinate method.
+ * @param sink Render target (see pixel_sink.h).
+ * @param xc X-coordinate of the center of the ellipse.
+ * @param yc Y-coordinate of the center of the ellipse.
+ * @param a Semi-major axis length.
+ * @param b Semi-minor axis length.
+ * @param c Color of the ellipse.
+ * This function calculates points on the ellipse using polar coordinates and writes them to the sink.
+ * Sample i lies at angle i * step. cos and sin are evaluated at every POLAR_RESEED_STEPS-th sample; in
+ * between the angle is advanced by rotation, which yields the same pixels.
+ * Only the samples of the arcs that meet the sink's bounds are taken: within a quadrant cos and sin
+ * are monotone, so those are one range of angles per quadrant.
+ */
+
+template <typename Sink>
+void Ellipse::DrawEllipsePolar(Sink& sink, int xc, int yc, int a, int b, COLORREF c) {
+    ClipSink<Sink> view(sink);
+    if (!view.overlaps((long long)xc - a, (long long)yc - b, (long long)xc + a, (long long)yc + b))
+        return;
+    if (std::max(a, b) <= 0) {
+        view.setPixel(xc + a, yc, c); // the one sample, at angle 0
+        return;
+    }
+    double step = 1.0 / std::max(a, b); // Adjust step size based on the ellipse dimensions
+    // Samples i with i * step < 2 pi
+    long long count = (long long)std::ceil(2 * M_PI / step);
+    while (count > 1 && (count - 1) * step >= 2 * M_PI) count--;
+    while (count * step < 2 * M_PI) count++;
+
+    std::pair<long long, long long> ranges[4];
+    int n = 0;
+    if (a > 0 && b > 0 && !view.covers((long long)xc - a, (long long)yc - b, (long long)xc + a, (long long)yc + b)) {
+        // a cos t and b sin t that round into the view, with a pixel to spare
+        RECT area = view.bounds();
+        double u0 = std::max(-1.0, ((double)area.left - 1.5 - xc) / a), u1 = std::min(1.0, ((double)area.right + 0.5 - xc) / a);
+        double v0 = std::max(-1.0, ((double)area.top - 1.5 - yc) / b), v1 = std::min(1.0, ((double)area.bottom + 0.5 - yc) / b);
+        if (u0 > u1 || v0 > v1)
+            return;
+        double c0 = acos(u1), c1 = acos(u0); // angles in [0, pi] whose cos is in range
+        double s0 = asin(v0), s1 = asin(v1); // angles in [-pi/2, pi/2] whose sin is in range
+        for (int q = 0; q < 4; q++) {
+            double lo = q * M_PI / 2, hi = (q + 1) * M_PI / 2;
+            if (q < 2) {
+                lo = std::max(lo, c0);
+                hi = std::min(hi, c1);
+            } else {
+                lo = std::max(lo, 2 * M_PI - c1);
+                hi = std::min(hi, 2 * M_PI - c0);
+            }
+            if (q == 0) {
+                lo = std::max(lo, s0);
+                hi = std::min(hi, s1);
+            } else if (q == 3) {
+                lo = std::max(lo, 2 * M_PI + s0);
+                hi = std::min(hi, 2 * M_PI + s1);
+            } else {
+                lo = std::max(lo, M_PI - s1);
+                hi = std::min(hi, M_PI - s0);
+            }
+            if (lo > hi)
+                continue;
+            // A sample to spare on each side for the rounding of the angles
+            long long first = std::max(0LL, (long long)std::floor(lo / step) - 1);
+            long long last = std::min(count - 1, (long long)std::ceil(hi / step) + 1);
+            if (first > last)
+                continue;
+            if (n > 0 && first <= ranges[n - 1].second + 1)
+                ranges[n - 1].second = std::max(ranges[n - 1].second, last);
+            else
+                ranges[n++] = {first, last};
+        }
+    } else {
+        ranges[n++] = {0, count - 1};
+    }
+
+    // (cs, sn) = (cos, sin) of the angle, turned by step with the rotation recurrence of
+    // SecondDegreeCurve::itreativepolar; reseeded from the exact angle now and then to bound drift
+    const double cosStep = cos(step), sinStep = sin(step);
+    for (int r = 0; r < n; r++) {
+        // Start from the reseed before the range, so the samples are those of the whole ellipse,
+        // and one sample early, to know whether the first pixel repeats its predecessor
+        long long from = ranges[r].first > 0 ? ranges[r].first - 1 : 0;
+        long long i = from - from % POLAR_RESEED_STEPS;
+        double cs = 1.0, sn = 0.0;
+        int lastX = 0, lastY = 0;
+        for (; i <= ranges[r].second; i++) {
+            if (i % POLAR_RESEED_STEPS == 0) {
+                cs = cos(i * step);
+                sn = sin(i * step);
+            }
+            int x = Common::Round(xc + a * cs);
+            int y = Common::Round(yc + b * sn);
+            // Neighbouring angles mostly land on the same pixel; write it once
+            if (i >= ranges[r].first && (i == 0 || x != lastX || y != lastY))
+                view.setPixel(x, y, c);
+            lastX = x;
+            lastY = y;
+            double next = cs * cosStep - sn * sinStep;
+            sn = sn * cosStep + cs * sinStep;
+            cs = next;
+        }
+    }
+}
+
+/**
+ * @brief Draws an ellipse using the standard ellipse equation.
+ * @param sink Render target (see pixel_sink.h).
+ * @param xc X-coordinate of the center of the ellipse.
+ * @param yc Y-coordinate of the center of the ellipse.
+ * @param a Semi-major axis length.
+ * @param b Semi-minor axis length.
+ * @param c Color of the ellipse.
+ * This function calculates points on the ellipse using the standard equation and writes them to the sink.
+ */
+template <typename Sink>
+void Ellipse::DrawEllipseEquation(Sink& sink, int xc, int yc, int a, int b, COLORREF c) {
+    ClipSink<Sink> view(sink);
+    if (!view.overlaps((long long)xc - a, (long long)yc - b, (long long)xc + a, (long long)yc + b))
+        return;
+    // Both loops run over the visible columns / rows only
+    RECT area = view.bounds();
+    int xFirst = (int)std::max<long long>(-a, (long long)area.left - xc);
+    int xLast = (int)std::min<long long>(a, (long long)area.right - 1 - xc);
+    int yFirst = (int)std::max<long long>(-b, (long long)area.top - yc);
+    int yLast = (int)std::min<long long>(b, (long long)area.bottom - 1 - yc);
+
+    if (a == 0 && b == 0) {
+        view.setPixel(xc, yc, c);
+        return;
+    }
+    if (a == 0) {
+        for (int y = yFirst; y <= yLast; y++) {
+            view.setPixel(xc, yc + y, c);
+        }
+        return;
+    }
+    if (b == 0) {
+        for (int x = xFirst; x <= xLast; x++) {
+            view.setPixel(xc + x, yc, c);
+        }
+        return;
+    }
+
+    // First loop: x-based drawing
+    for (int x = xFirst; x <= xLast; x++) {
+        double y_sq = (1.0 - (double)(x * x) / (a * a)) * (b * b);
+        if (y_sq >= 0) {
+            int y = round(sqrt(y_sq));
+            view.setPixel(xc + x, yc + y, c);
+            view.setPixel(xc + x, yc - y, c);
+        }
+    }
+
+    // Second loop: y-based drawing (needed for tall ellipses)
+    for (int y = yFirst; y <= yLast; y++) {
+        double x_sq = (1.0 - (double)(y * y) / (b * b)) * (a * a);
+        if (x_sq >= 0) {
+            int x = round(sqrt(x_sq));
+            view.setPixel(xc + x, yc + y, c);
+            view.setPixel(xc - x, yc + y, c);
+        }
+    }
+}
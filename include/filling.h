@@ -1,11 +1,16 @@
 #pragma once
-#include <windows.h>
-#include <list>
-#include <queue>
+#include "platform.h"
+#include "pixel_sink.h"
+#include "span_mask.h"
+#include <climits>
+#include <cstdint>
 #include <vector>
 #include <algorithm>
-#include "../include/common.h"
-#include "../include/lines.h"
+#include "common.h"
+#include "lines.h"
+#include "curves_second_degree.h"
+#include "curves_third_degree.h"
+#include <cmath>
 
 class Filling {
 public:
@@ -33,33 +38,537 @@ public:
     static void NonConvexFill(HDC hdc, const std::vector<Point>& points, COLORREF color);
     static void NonConvexFill(HDC hdc, const std::vector<POINT>& points, COLORREF color);
 
+    // Hard cap on the depth-first fill stack (entries); larger regions finish with the scanline fill
+    static const size_t FLOOD_STACK_LIMIT = 1 << 20;
+
     // --- Extra menu ---
+    // Pattern parameters, shared with LayerBounds so boxes cover the whole pattern
+    static const int WAVE_HEIGHT = 15;          // wave amplitude
+    static const int WAVE_LENGTH = 40;          // length of one wave cycle
+    static const int SMALL_CIRCLE_MAX_RADIUS = 4;
     static void FillQuarterWithSmallCircles(HDC hdc, int xc, int yc, int R, int quarter, COLORREF c);
     static void FillRectangleWithBezierWaves(HDC hdc, int left, int top, int right, int bottom, COLORREF c);
     static void FillCircleQuarter(HDC hdc, int xc, int yc, int radius, int quarter, COLORREF c);
     static void FillSquareWithVerticalHermiteWaves(HDC hdc, int left, int top, int size, COLORREF c);
 
+    // Sink-based versions (see pixel_sink.h); the HDC overloads forward to these
+    template <typename Sink>
+    static void RecursiveFloodFill(Sink& sink, int x, int y, COLORREF color);
+    // Depth-first fill on an explicit stack limited to `bounds`; the overload above uses sink.bounds()
+    template <typename Sink>
+    static void RecursiveFloodFill(Sink& sink, int x, int y, COLORREF color, const RECT& bounds);
+    template <typename Sink>
+    static void NonRecursiveFloodFill(Sink& sink, int x, int y, COLORREF color);
+    // Scanline seed fill limited to `bounds` (right/bottom exclusive); the overload above uses sink.bounds()
+    template <typename Sink>
+    static void NonRecursiveFloodFill(Sink& sink, int x, int y, COLORREF color, const RECT& bounds);
+    // Edge-function triangle rasterizer; tileRejection skips/accepts whole 8x8 tiles before testing pixels
+    template <typename Sink>
+    static void BarycentricFill(Sink& sink, int x1, int y1, int x2, int y2, int x3, int y3, COLORREF color, bool tileRejection = true);
+    template <typename Sink>
+    static void ConvexFill(Sink& sink, const std::vector<Point>& points, COLORREF color);
+    template <typename Sink>
+    static void ConvexFill(Sink& sink, const std::vector<POINT>& points, COLORREF color);
+    // Active edge table scanline fill; `rule` decides which regions of a self-intersecting polygon are inside
+    template <typename Sink>
+    static void NonConvexFill(Sink& sink, const std::vector<Point>& points, COLORREF color, FillRule rule = FILL_RULE_EVEN_ODD);
+    template <typename Sink>
+    static void NonConvexFill(Sink& sink, const std::vector<POINT>& points, COLORREF color, FillRule rule = FILL_RULE_EVEN_ODD);
+    // batchRows emits the stamps of one grid row together, row by row, instead of stamp by stamp
+    template <typename Sink>
+    static void FillQuarterWithSmallCircles(Sink& sink, int xc, int yc, int R, int quarter, COLORREF c, bool batchRows = true);
+    template <typename Sink>
+    static void FillRectangleWithBezierWaves(Sink& sink, int left, int top, int right, int bottom, COLORREF c);
+    template <typename Sink>
+    static void FillCircleQuarter(Sink& sink, int xc, int yc, int radius, int quarter, COLORREF c);
+    template <typename Sink>
+    static void FillSquareWithVerticalHermiteWaves(Sink& sink, int left, int top, int size, COLORREF c);
+
 private:
-    // Edge table structures
+    // One bit per pixel of the fill bounds, so a seed fill never tests a pixel twice
+    class VisitedBitmap {
+    public:
+        explicit VisitedBitmap(const RECT& bounds)
+            : area(bounds),
+              width(bounds.right > bounds.left ? (size_t)(bounds.right - bounds.left) : 0),
+              bits((width * (bounds.bottom > bounds.top ? (size_t)(bounds.bottom - bounds.top) : 0) + 63) / 64, 0) {}
+
+        bool contains(int x, int y) const {
+            return x >= area.left && x < area.right && y >= area.top && y < area.bottom;
+        }
+        bool test(int x, int y) const { size_t i = index(x, y); return (bits[i >> 6] >> (i & 63)) & 1; }
+        void set(int x, int y) { size_t i = index(x, y); bits[i >> 6] |= (uint64_t)1 << (i & 63); }
+
+    private:
+        size_t index(int x, int y) const { return (size_t)(y - area.top) * width + (size_t)(x - area.left); }
+        RECT area;
+        size_t width;
+        std::vector<uint64_t> bits;
+    };
+    // A run [x1, x2] of row y still to be scanned, reached from row y - dy
+    struct SeedSpan { int x1, x2, y, dy; };
+    struct SeedPixel { int x, y; };
+
+    // Integer edge function of a->b: >= 0 on the interior side. The -1 bias on edges that are
+    // not top or left implements the top-left rule, so triangles sharing an edge never overlap.
+    struct EdgeFunction {
+        int64_t stepX, stepY, origin;
+        EdgeFunction(int ax, int ay, int bx, int by)
+            : stepX(-(int64_t)(by - ay)), stepY((int64_t)(bx - ax)),
+              origin(-(int64_t)ax * stepX - (int64_t)ay * stepY - (IsTopLeft(ax, ay, bx, by) ? 0 : 1)) {}
+        int64_t at(int x, int y) const { return origin + stepX * x + stepY * y; }
+        static bool IsTopLeft(int ax, int ay, int bx, int by) { return by < ay || (by == ay && bx > ax); }
+    };
+    static const int TRIANGLE_LANES = 8;
+    static const int TRIANGLE_TILE = 8;
+    // Per-thread stack reused by every RecursiveFloodFill call, so it only grows once
+    static std::vector<SeedPixel>& FloodStack();
+
+    // Edge table structures; a table covers rows [top, top + size) of the polygon, clipped to the sink
     struct ConvexEdgeTable {
         int xleft, xright;
-        ConvexEdgeTable() : xleft(10000), xright(-10000) {}
+        ConvexEdgeTable() : xleft(INT_MAX), xright(INT_MIN) {}
     };
-    typedef std::list<int> NonConvexEdgeTable[800];
-    typedef ConvexEdgeTable ConvexEdgeTableArray[800];
+    typedef std::vector<ConvexEdgeTable> ConvexEdgeTableArray;
+
+    // Rows crossed by the polygon's edges, clipped to `bounds`; false when none is visible
+    static bool PolygonRows(const std::vector<Point>& points, const RECT& bounds, int& top, int& bottom);
 
     // Helper methods for convex filling
-    static void InitConvexEdgeTable(ConvexEdgeTableArray& table);
-    static void EdgeToConvexTable(const Point& v1, const Point& v2, ConvexEdgeTableArray& table);
-    static void PolygonToConvexTable(const std::vector<Point>& points, ConvexEdgeTableArray& table);
-    static void ConvexTableToScreen(HDC hdc, const ConvexEdgeTableArray& table, COLORREF color);
+    static void InitConvexEdgeTable(ConvexEdgeTableArray& table, int rows);
+    static void EdgeToConvexTable(const Point& v1, const Point& v2, ConvexEdgeTableArray& table, int top);
+    static void PolygonToConvexTable(const std::vector<Point>& points, ConvexEdgeTableArray& table, int top);
+    template <typename Sink>
+    static void ConvexTableToScreen(Sink& sink, const ConvexEdgeTableArray& table, int top, COLORREF color);
+
+    // Non-convex filling: a flat-array version of the Clipping::Node/LinkedList active edge table.
+    // Edges live in one vector sorted by minY (the buckets); the active list is another vector kept
+    // sorted by x through merging entering edges and insertion steps after each x update.
+    struct PolygonEdge {
+        int minY, maxY; // crosses rows [minY, maxY)
+        double x;       // x on the current row
+        double minv;    // 1/m
+        int dir;        // +1 when the polygon runs down this edge, -1 when up (nonzero winding)
+    };
+    // Edges are cut to rows [top, bottom)
+    static void PolygonToEdgeList(const std::vector<Point>& points, std::vector<PolygonEdge>& edges, int top, int bottom);
+    template <typename Sink>
+    static void ActiveEdgeTableToScreen(Sink& sink, const std::vector<PolygonEdge>& edges, std::vector<PolygonEdge>& active,
+                                        COLORREF color, FillRule rule);
+
+    // Scanline tables, one set per thread, reused so repeated fills don't allocate
+    struct ScanlineBuffers {
+        ConvexEdgeTableArray convex;
+        std::vector<PolygonEdge> edges;
+        std::vector<PolygonEdge> active;
+    };
+    static ScanlineBuffers& FillBuffers();
+
+    // Raster of BresenhamCircle(0, 0, r) for r in 1..SMALL_CIRCLE_MAX_RADIUS, built once
+    static const SpanMask& SmallCircleStamp(int r);
 
-    // Helper methods for non-convex filling
-    static void InitNonConvexEdgeTable(NonConvexEdgeTable& table);
-    static void EdgeToNonConvexTable(const Point& v1, const Point& v2, NonConvexEdgeTable& table);
-    static void PolygonToNonConvexTable(const std::vector<Point>& points, NonConvexEdgeTable& table);
-    static void NonConvexTableToScreen(HDC hdc, const NonConvexEdgeTable& table, COLORREF color);
+    // Raster of one wave period of each wave fill, relative to the period's start point, built once
+    static const SpanMask& BezierWavePeriod();
+    static const SpanMask& HermiteWavePeriod();
+
+    // Replays `pattern` moved by (dx, dy), dropping what falls outside `clip` (right/bottom exclusive)
+    template <typename Sink>
+    static void StampPattern(Sink& sink, const SpanMask& pattern, int dx, int dy, const RECT& clip, COLORREF c);
+    // The pixels of [left, right] x [top, bottom] that the sink can write
+    template <typename Sink>
+    static RECT PatternClip(Sink& sink, int left, int top, int right, int bottom);
 
     // Utility methods
     static std::vector<Point> ConvertToPoints(const std::vector<POINT>& points);
-};
\ No newline at end of file
+};
+
+template <typename Sink>
+void Filling::RecursiveFloodFill(Sink& sink, int x, int y, COLORREF color) {
+    RecursiveFloodFill(sink, x, y, color, sink.bounds());
+}
+
+template <typename Sink>
+void Filling::RecursiveFloodFill(Sink& sink, int x, int y, COLORREF color, const RECT& bounds) {
+    // Four-neighbour depth-first fill like the original recursion, but the pending pixels live
+    // on a heap stack; marking them when pushed keeps it no larger than the fill area
+    static const int dx[4] = {-1, 0, 1, 0}; // reversed, so the first neighbour is popped first
+    static const int dy[4] = {0, -1, 0, 1};
+    VisitedBitmap visited(bounds);
+    auto inside = [&](int px, int py) {
+        if (!visited.contains(px, py) || visited.test(px, py)) return false;
+        COLORREF current = sink.getPixel(px, py);
+        return current != color && current != CLR_INVALID;
+    };
+    if (!inside(x, y)) return;
+
+    std::vector<SeedPixel>& stack = FloodStack();
+    stack.clear();
+    stack.push_back(SeedPixel{x, y});
+    visited.set(x, y);
+    while (!stack.empty()) {
+        SeedPixel p = stack.back();
+        stack.pop_back();
+        sink.setPixel(p.x, p.y, color);
+        for (int i = 0; i < 4; i++) {
+            int nx = p.x + dx[i], ny = p.y + dy[i];
+            if (!inside(nx, ny)) continue;
+            if (stack.size() >= FLOOD_STACK_LIMIT) {
+                // Out of budget: the scanline fill finishes this part in O(height) memory
+                NonRecursiveFloodFill(sink, nx, ny, color, bounds);
+                continue;
+            }
+            visited.set(nx, ny);
+            stack.push_back(SeedPixel{nx, ny});
+        }
+    }
+}
+
+template <typename Sink>
+void Filling::NonRecursiveFloodFill(Sink& sink, int x, int y, COLORREF color) {
+    NonRecursiveFloodFill(sink, x, y, color, sink.bounds());
+}
+
+template <typename Sink>
+void Filling::NonRecursiveFloodFill(Sink& sink, int x, int y, COLORREF color, const RECT& bounds) {
+    // Smith/Heckbert scanline fill: each stack entry is a run next to an already filled run,
+    // so the stack holds O(height) runs and every pixel is read at most a few times
+    VisitedBitmap visited(bounds);
+    auto inside = [&](int px, int py) {
+        if (!visited.contains(px, py) || visited.test(px, py)) return false;
+        COLORREF current = sink.getPixel(px, py);
+        return current != color && current != CLR_INVALID;
+    };
+    if (!inside(x, y)) return;
+
+    std::vector<SeedSpan> stack;
+    stack.push_back(SeedSpan{x, x, y, 1});
+    stack.push_back(SeedSpan{x, x, y - 1, -1});
+    while (!stack.empty()) {
+        SeedSpan span = stack.back();
+        stack.pop_back();
+        int x1 = span.x1, row = span.y, dy = span.dy;
+        int left = x1;
+        // Extend the run to the left of the parent run; that part may leak back to the parent row
+        // Runs are marked visited while scanning and written with one fillSpan
+        if (inside(left, row)) {
+            while (inside(left - 1, row)) {
+                visited.set(left - 1, row);
+                left--;
+            }
+            if (left < x1) {
+                sink.fillSpan(row, left, x1 - 1, color);
+                stack.push_back(SeedSpan{left, x1 - 1, row - dy, -dy});
+            }
+        }
+        while (x1 <= span.x2) {
+            int runStart = x1;
+            while (inside(x1, row)) {
+                visited.set(x1, row);
+                x1++;
+            }
+            if (x1 > runStart) sink.fillSpan(row, runStart, x1 - 1, color);
+            if (x1 > left) stack.push_back(SeedSpan{left, x1 - 1, row + dy, dy});
+            // Overhang past the parent run's right end
+            if (x1 - 1 > span.x2) stack.push_back(SeedSpan{span.x2 + 1, x1 - 1, row - dy, -dy});
+            x1++;
+            while (x1 < span.x2 && !inside(x1, row)) x1++;
+            left = x1;
+        }
+    }
+}
+
+template <typename Sink>
+void Filling::BarycentricFill(Sink& sink, int x1, int y1, int x2, int y2, int x3, int y3, COLORREF color, bool tileRejection) {
+    // Orient the triangle so the interior is where all three edge functions are non-negative
+    int64_t area = (int64_t)(x2 - x1) * (y3 - y1) - (int64_t)(y2 - y1) * (x3 - x1);
+    if (area == 0) return;
+    if (area < 0) {
+        std::swap(x2, x3);
+        std::swap(y2, y3);
+    }
+    const EdgeFunction edges[3] = {EdgeFunction(x1, y1, x2, y2), EdgeFunction(x2, y2, x3, y3), EdgeFunction(x3, y3, x1, y1)};
+
+    // Bounding box clipped to the sink, right/bottom exclusive
+    RECT bounds = sink.bounds();
+    int left = std::max<int>(std::min({x1, x2, x3}), bounds.left);
+    int top = std::max<int>(std::min({y1, y2, y3}), bounds.top);
+    int right = std::min<int>(std::max({x1, x2, x3}) + 1, bounds.right);
+    int bottom = std::min<int>(std::max({y1, y2, y3}) + 1, bounds.bottom);
+    if (left >= right || top >= bottom) return;
+
+    // Tests [x0, x1) of row y in blocks of TRIANGLE_LANES pixels. The lanes are independent adds
+    // and a sign test, which the compiler turns into SIMD compares; only covered pixels are written.
+    auto scanRow = [&](int y, int x0, int xEnd) {
+        int64_t w[3] = {edges[0].at(x0, y), edges[1].at(x0, y), edges[2].at(x0, y)};
+        for (int x = x0; x < xEnd; x += TRIANGLE_LANES) {
+            unsigned mask = 0;
+            for (int lane = 0; lane < TRIANGLE_LANES; lane++) {
+                int64_t v = (w[0] + lane * edges[0].stepX) | (w[1] + lane * edges[1].stepX) | (w[2] + lane * edges[2].stepX);
+                mask |= (unsigned)(v >= 0) << lane;
+            }
+            if (xEnd - x < TRIANGLE_LANES) mask &= (1u << (xEnd - x)) - 1;
+            // A row of a triangle is convex, so covered lanes form one run
+            if (mask) {
+                int first = 0, last = TRIANGLE_LANES - 1;
+                while (!(mask >> first & 1)) first++;
+                while (!(mask >> last & 1)) last--;
+                sink.fillSpan(y, x + first, x + last, color);
+            }
+            for (int i = 0; i < 3; i++) w[i] += TRIANGLE_LANES * edges[i].stepX;
+        }
+    };
+
+    if (!tileRejection) {
+        for (int y = top; y < bottom; y++) scanRow(y, left, right);
+        return;
+    }
+    for (int ty = top; ty < bottom; ty += TRIANGLE_TILE) {
+        int tyEnd = std::min(ty + TRIANGLE_TILE, bottom);
+        for (int tx = left; tx < right; tx += TRIANGLE_TILE) {
+            int txEnd = std::min(tx + TRIANGLE_TILE, right);
+            // Edge functions are linear, so their extremes over a tile are at its corners
+            bool outside = false, covered = true;
+            for (const EdgeFunction& e : edges) {
+                int64_t c[4] = {e.at(tx, ty), e.at(txEnd - 1, ty), e.at(tx, tyEnd - 1), e.at(txEnd - 1, tyEnd - 1)};
+                int64_t lo = std::min({c[0], c[1], c[2], c[3]});
+                int64_t hi = std::max({c[0], c[1], c[2], c[3]});
+                if (hi < 0) outside = true;
+                if (lo < 0) covered = false;
+            }
+            if (outside) continue;
+            for (int y = ty; y < tyEnd; y++) {
+                if (covered) {
+                    sink.fillSpan(y, tx, txEnd - 1, color);
+                } else {
+                    scanRow(y, tx, txEnd);
+                }
+            }
+        }
+    }
+}
+
+template <typename Sink>
+void Filling::ConvexTableToScreen(Sink& sink, const ConvexEdgeTableArray& table, int top, COLORREF color) {
+    for (size_t i = 0; i < table.size(); i++) {
+        if (table[i].xleft < table[i].xright) {
+            sink.fillSpan(top + (int)i, table[i].xleft, table[i].xright, color);
+        }
+    }
+}
+
+template <typename Sink>
+void Filling::ConvexFill(Sink& sink, const std::vector<Point>& points, COLORREF color) {
+    int top, bottom;
+    if (!PolygonRows(points, sink.bounds(), top, bottom)) return;
+    ConvexEdgeTableArray& table = FillBuffers().convex;
+    InitConvexEdgeTable(table, bottom - top);
+    PolygonToConvexTable(points, table, top);
+    ConvexTableToScreen(sink, table, top, color);
+}
+
+template <typename Sink>
+void Filling::ConvexFill(Sink& sink, const std::vector<POINT>& points, COLORREF color) {
+    ConvexFill(sink, ConvertToPoints(points), color);
+}
+
+template <typename Sink>
+void Filling::ActiveEdgeTableToScreen(Sink& sink, const std::vector<PolygonEdge>& edges, std::vector<PolygonEdge>& active,
+                                       COLORREF color, FillRule rule) {
+    auto byX = [](const PolygonEdge& a, const PolygonEdge& b) { return a.x < b.x; };
+    active.clear();
+    size_t next = 0;
+    int y = edges.empty() ? 0 : edges[0].minY;
+    while (next < edges.size() || !active.empty()) {
+        if (active.empty() && edges[next].minY > y) y = edges[next].minY; // skip empty rows
+
+        // Merge the edges starting on this row into the sorted active list
+        size_t entering = active.size();
+        while (next < edges.size() && edges[next].minY == y) active.push_back(edges[next++]);
+        std::sort(active.begin() + entering, active.end(), byX);
+        std::inplace_merge(active.begin(), active.begin() + entering, active.end(), byX);
+
+        if (rule == FILL_RULE_EVEN_ODD) {
+            for (size_t i = 0; i + 1 < active.size(); i += 2) {
+                sink.fillSpan(y, (int)round(active[i].x), (int)round(active[i + 1].x), color);
+            }
+        } else {
+            int winding = 0, start = 0;
+            for (const PolygonEdge& e : active) {
+                int before = winding;
+                winding += e.dir;
+                if (before == 0 && winding != 0) start = (int)round(e.x);
+                else if (before != 0 && winding == 0) sink.fillSpan(y, start, (int)round(e.x), color);
+            }
+        }
+
+        // Drop finished edges, step the rest; only edges that crossed need to move
+        y++;
+        active.erase(std::remove_if(active.begin(), active.end(), [y](const PolygonEdge& e) { return e.maxY <= y; }), active.end());
+        for (PolygonEdge& e : active) e.x += e.minv;
+        for (size_t i = 1; i < active.size(); i++) {
+            PolygonEdge e = active[i];
+            size_t j = i;
+            for (; j > 0 && active[j - 1].x > e.x; j--) active[j] = active[j - 1];
+            active[j] = e;
+        }
+    }
+}
+
+template <typename Sink>
+void Filling::NonConvexFill(Sink& sink, const std::vector<Point>& points, COLORREF color, FillRule rule) {
+    int top, bottom;
+    if (!PolygonRows(points, sink.bounds(), top, bottom)) return;
+    ScanlineBuffers& buffers = FillBuffers();
+    PolygonToEdgeList(points, buffers.edges, top, bottom);
+    ActiveEdgeTableToScreen(sink, buffers.edges, buffers.active, color, rule);
+}
+
+template <typename Sink>
+void Filling::NonConvexFill(Sink& sink, const std::vector<POINT>& points, COLORREF color, FillRule rule) {
+    NonConvexFill(sink, ConvertToPoints(points), color, rule);
+}
+
+template <typename Sink>
+void Filling::FillQuarterWithSmallCircles(Sink& sink, int xc, int yc, int R, int quarter, COLORREF c, bool batchRows)
+    {
+        const int maxRadius = SMALL_CIRCLE_MAX_RADIUS;
+        const int minRadius = 1;
+
+        // Small circles are stamped from precomputed rasters instead of running BresenhamCircle each time
+        struct Placement { int x; const SpanMask* stamp; size_t next; };
+        std::vector<Placement> row;
+
+        for (int y = -R; y <= R; y += 2 * maxRadius)
+        {
+            row.clear();
+            for (int x = -R; x <= R; x += 2 * maxRadius)
+            {
+                double distSquared = x * x + y * y;
+                if (distSquared <= R * R)
+                {
+                    bool inQuarter = false;
+                    switch (quarter)
+                    {
+                        case 1: inQuarter = (x >= 0 && y <= 0); break;
+                        case 2: inQuarter = (x <= 0 && y <= 0); break;
+                        case 3: inQuarter = (x <= 0 && y >= 0); break;
+                        case 4: inQuarter = (x >= 0 && y >= 0); break;
+                    }
+
+                    if (inQuarter)
+                    {
+                        double dist = sqrt(distSquared);
+                        double ratio = dist / R;
+                        int rSmall = static_cast<int>(minRadius + (1.0 - ratio) * (maxRadius - minRadius));
+
+                        if (rSmall < 1) rSmall = 1;
+
+                        if (batchRows)
+                            row.push_back(Placement{xc + x, &SmallCircleStamp(rSmall), 0});
+                        else
+                            SmallCircleStamp(rSmall).Replay(sink, c, xc + x, yc + y);
+                    }
+                }
+            }
+
+            // Stamp spans are sorted by row, so each placement keeps a cursor into its own spans
+            for (int dy = -maxRadius; dy <= maxRadius && !row.empty(); dy++)
+            {
+                for (Placement& p : row)
+                {
+                    const std::vector<SpanMask::Span>& spans = p.stamp->spans();
+                    for (; p.next < spans.size() && spans[p.next].y == dy; p.next++)
+                        sink.fillSpan(yc + y + dy, p.x + spans[p.next].x0, p.x + spans[p.next].x1, c);
+                }
+            }
+        }
+    }
+
+template <typename Sink>
+void Filling::StampPattern(Sink& sink, const SpanMask& pattern, int dx, int dy, const RECT& clip, COLORREF c)
+    {
+        for (const SpanMask::Span& s : pattern.spans())
+        {
+            int y = s.y + dy;
+            if (y < clip.top || y >= clip.bottom) continue;
+            int x0 = std::max<int>(s.x0 + dx, clip.left);
+            int x1 = std::min<int>(s.x1 + dx, clip.right - 1);
+            if (x0 <= x1) sink.fillSpan(y, x0, x1, c);
+        }
+    }
+
+template <typename Sink>
+RECT Filling::PatternClip(Sink& sink, int left, int top, int right, int bottom)
+    {
+        RECT bounds = sink.bounds();
+        return RECT{std::max<LONG>(left, bounds.left), std::max<LONG>(top, bounds.top),
+                    std::min<LONG>(right + 1, bounds.right), std::min<LONG>(bottom + 1, bounds.bottom)};
+    }
+
+template <typename Sink>
+void Filling::FillRectangleWithBezierWaves(Sink& sink, int left, int top, int right, int bottom, COLORREF c)
+    {
+        int waveLength = WAVE_LENGTH;   // length of wave cycle
+        int stepY = 6;         // smaller vertical step for denser waves
+
+        // Every period is the same curve moved, so one raster is stamped and clipped to the rectangle
+        const SpanMask& period = BezierWavePeriod();
+        RECT clip = PatternClip(sink, left, top, right, bottom);
+
+        for (int y = top; y <= bottom; y += stepY)
+        {
+            for (int x = left; x < right; x += waveLength)
+            {
+                StampPattern(sink, period, x, y, clip, c);
+            }
+        }
+    }
+
+template <typename Sink>
+void Filling::FillCircleQuarter(Sink& sink, int xc, int yc, int radius, int quarter, COLORREF c)
+    {
+        // Clamp quarter input between 1 and 4
+        if (quarter < 1 || quarter > 4 || radius < 0) return;
+
+        // Quarters are counted counter-clockwise from the top-right one (y axis inverted in GDI)
+        bool right = quarter == 1 || quarter == 4;
+        bool above = quarter == 1 || quarter == 2;
+
+        // One span per row: the sector holds the pixels with dx^2 + dy^2 <= r^2 on its side of
+        // both axes. The half-width only shrinks as dy grows, so it is found incrementally.
+        RECT bounds = sink.bounds();
+        long long r2 = (long long)radius * radius;
+        int halfWidth = radius;
+        for (int dy = 0; dy <= radius; dy++)
+        {
+            while ((long long)halfWidth * halfWidth + (long long)dy * dy > r2) halfWidth--;
+            int y = above ? yc - dy : yc + dy;
+            if (y < bounds.top || y >= bounds.bottom) continue;
+            if (right)
+                sink.fillSpan(y, xc, xc + halfWidth, c);
+            else
+                sink.fillSpan(y, xc - halfWidth, xc, c);
+        }
+    }
+
+template <typename Sink>
+void Filling::FillSquareWithVerticalHermiteWaves(Sink& sink, int left, int top, int size, COLORREF c)
+{
+	int waveLength = WAVE_LENGTH;  // Vertical wave cycle
+	int stepX = 6;        // Horizontal step for density
+
+	int right = left + size;
+	int bottom = top + size;
+
+	// Every period is the same curve moved, so one raster is stamped and clipped to the square
+	const SpanMask& period = HermiteWavePeriod();
+	RECT clip = PatternClip(sink, left, top, right, bottom);
+
+	for (int x = left; x <= right; x += stepX)
+	{
+		for (int y = top; y < bottom; y += waveLength)
+		{
+			StampPattern(sink, period, x, y, clip, c);
+		}
+	}
+}
@@ -9,7 +9,7 @@
 #include <queue>
 
 #define WIN32_LEAN_AND_MEAN // Exclude rarely-used stuff from Windows headers
-#include <windows.h>
+#include "platform.h"
 
 // Project headers
 #include "common.h"
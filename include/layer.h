@@ -1,5 +1,8 @@
 #pragma once
-#include <windows.h>
+#include "platform.h"
+#include "span_mask.h"
+#include <memory>
+#include <optional>
 #include <vector>
 #include <variant>
 
@@ -10,12 +13,15 @@ struct LayerEllipse { POINT center; int a, b; COLORREF color; int alg; };
 struct LayerRect { POINT p1, p2; COLORREF color; };
 struct LayerPolygon { std::vector<POINT> pts; COLORREF color; };
 struct LayerPoint { POINT pt; COLORREF color; };
-struct LayerFill { POINT fillPoint; COLORREF color; int alg; };
+// target: index of the filled shape in the layer list, resolved on creation/load (not saved)
+// spans: flood-fill result recorded on first render and replayed afterwards (not saved)
+// extent: bounding box of a flood without spans, worked out on the first query (not saved)
+struct LayerFill { POINT fillPoint; COLORREF color; int alg; int target = -1; mutable std::shared_ptr<const SpanMask> spans; mutable std::optional<RECT> extent; };
 struct LayerQuarterCircleFilling { POINT center; int radius; int quarter; COLORREF color; };
 struct LayerRectangleBezierWaves { POINT p1, p2; COLORREF color; };
 struct LayerCircleQuarter { POINT center; int radius; int quarter; COLORREF color; };
 struct LayerSquareHermiteWaves { POINT topLeft; int size; COLORREF color; };
-struct LayerBezierCurve { POINT p0, p1, p2, p3; COLORREF color; };
+struct LayerBezierCurve { POINT p0, p1, p2, p3; COLORREF color; int alg; };
 typedef std::vector<double> CardinalSplinePoints;
 struct LayerCardinalSpline { CardinalSplinePoints points; COLORREF color; };
 using LayerShape = std::variant<LayerLine, LayerCircle, LayerEllipse, LayerRect, LayerPolygon, LayerPoint, LayerFill, LayerQuarterCircleFilling, LayerRectangleBezierWaves, LayerCircleQuarter, LayerSquareHermiteWaves, LayerBezierCurve, LayerCardinalSpline>;
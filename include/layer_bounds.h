@@ -0,0 +1,36 @@
+// Bounding boxes of layers, used for dirty-rectangle invalidation
+#pragma once
+#include "platform.h"
+#include "layer.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * LayerBounds - conservative pixel bounding boxes for every LayerShape alternative.
+ * Boxes use the GDI convention (right/bottom exclusive) and include a one pixel margin
+ * for the rounding done by the rasterizers. Curves use their control hulls.
+ */
+class LayerBounds {
+public:
+    // Box of layers[index]; a fill is bounded by its recorded spans, else by the shape it fills
+    // (its target layer), or by Everything when a flood from its seed escapes that shape's outline.
+    // `canvas` is the area the layers are drawn into; floods are only followed inside it
+    static RECT Of(const std::vector<Layer>& layers, size_t index, const RECT& canvas);
+    // Box of a single shape; fills need their target and return an empty box here
+    static RECT OfShape(const LayerShape& shape);
+
+    static bool IsEmpty(const RECT& r);
+    static bool Intersects(const RECT& a, const RECT& b);
+    static bool Contains(const RECT& outer, const RECT& inner);
+    static bool ContainsPoint(const RECT& r, POINT p);
+    static RECT Union(const RECT& a, const RECT& b);
+    static RECT Intersection(const RECT& a, const RECT& b);
+    // Box around a point set (e.g. preview geometry)
+    static RECT OfPoints(const POINT* points, size_t n, int margin = 1);
+
+    static const RECT Empty;
+    static const RECT Everything;
+
+private:
+    static RECT FromCenter(POINT center, int rx, int ry, int margin);
+};
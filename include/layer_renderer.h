@@ -0,0 +1,233 @@
+// Rasterizes layers into any pixel sink (window DC or in-memory framebuffer)
+#pragma once
+#include "platform.h"
+#include "pixel_sink.h"
+#include "layer.h"
+#include "layer_bounds.h"
+#include "common.h"
+#include "lines.h"
+#include "curves_second_degree.h"
+#include "circle_cache.h"
+#include "curves_third_degree.h"
+#include "ellipse.h"
+#include "filling.h"
+#include <variant>
+#include <vector>
+
+/**
+ * LayerRenderer - the layer dispatch shared by WM_PAINT and the headless renderer.
+ * Each layer is drawn with the algorithm recorded in it, in layer order.
+ */
+class LayerRenderer {
+public:
+    // Draws an open polyline using the midpoint line algorithm
+    template <typename Sink>
+    static void DrawPolygon(Sink& sink, const std::vector<POINT>& points, COLORREF color);
+
+    // Draws one layer; `layers` is only used to look up the target shape of a LayerFill
+    template <typename Sink>
+    static void RenderLayer(Sink& sink, const std::vector<Layer>& layers, const Layer& layer);
+
+    template <typename Sink>
+    static void RenderLayers(Sink& sink, const std::vector<Layer>& layers);
+
+    // Renders layers[0..count) whose bounding box intersects `rect`, skipping the rest
+    template <typename Sink>
+    static void RenderLayersInRect(Sink& sink, const std::vector<Layer>& layers, size_t count, const RECT& rect);
+
+    // Drops the recorded spans and extents of every fill after layers[changed], whose result may depend on it
+    static void InvalidateFillCaches(const std::vector<Layer>& layers, size_t changed);
+
+private:
+    template <typename Sink>
+    static void FillTarget(Sink& sink, const LayerFill& shape, const LayerShape& target);
+};
+
+template <typename Sink>
+void LayerRenderer::DrawPolygon(Sink& sink, const std::vector<POINT>& points, COLORREF color) {
+    if (points.size() < 2) return;
+
+    // Draw lines between consecutive points using midpoint algorithm
+    for (size_t i = 0; i < points.size() - 1; i++) {
+        Lines::DrawLineByMidPoint(sink, points[i].x, points[i].y, points[i + 1].x, points[i + 1].y, color);
+    }
+}
+
+template <typename Sink>
+void LayerRenderer::RenderLayers(Sink& sink, const std::vector<Layer>& layers) {
+    for (const auto& layer : layers) {
+        RenderLayer(sink, layers, layer);
+    }
+}
+
+template <typename Sink>
+void LayerRenderer::RenderLayersInRect(Sink& sink, const std::vector<Layer>& layers, size_t count, const RECT& rect) {
+    for (size_t i = 0; i < count && i < layers.size(); ++i) {
+        if (LayerBounds::Intersects(LayerBounds::Of(layers, i, sink.bounds()), rect)) {
+            RenderLayer(sink, layers, layers[i]);
+        }
+    }
+}
+
+template <typename Sink>
+void LayerRenderer::FillTarget(Sink& sink, const LayerFill& shape, const LayerShape& target) {
+    std::visit([&](auto&& prevShape) {
+        using P = std::decay_t<decltype(prevShape)>;
+        if constexpr (std::is_same_v<P, LayerPolygon>) {
+            if (prevShape.pts.size() >= 3) {
+                switch (shape.alg) {
+                    case FILL_RECURSIVE_FLOOD:
+                        Filling::RecursiveFloodFill(sink, shape.fillPoint.x, shape.fillPoint.y, shape.color);
+                        break;
+                    case FILL_NONRECURSIVE_FLOOD:
+                        Filling::NonRecursiveFloodFill(sink, shape.fillPoint.x, shape.fillPoint.y, shape.color);
+                        break;
+                    case FILL_CONVEX:
+                        if (Common::IsConvex(prevShape.pts)) {
+                            Filling::ConvexFill(sink, prevShape.pts, shape.color);
+                        }
+                        break;
+                    case FILL_NONCONVEX:
+                        Filling::NonConvexFill(sink, prevShape.pts, shape.color);
+                        break;
+                }
+            }
+        } else if constexpr (std::is_same_v<P, LayerRect>) {
+            std::vector<POINT> rectPoints = {
+                prevShape.p1,
+                {prevShape.p2.x, prevShape.p1.y},
+                prevShape.p2,
+                {prevShape.p1.x, prevShape.p2.y},
+                prevShape.p1
+            };
+            switch (shape.alg) {
+                case FILL_RECURSIVE_FLOOD:
+                    Filling::RecursiveFloodFill(sink, shape.fillPoint.x, shape.fillPoint.y, shape.color);
+                    break;
+                case FILL_NONRECURSIVE_FLOOD:
+                    Filling::NonRecursiveFloodFill(sink, shape.fillPoint.x, shape.fillPoint.y, shape.color);
+                    break;
+                case FILL_CONVEX:
+                    Filling::ConvexFill(sink, rectPoints, shape.color);
+                    break;
+                case FILL_NONCONVEX:
+                    Filling::NonConvexFill(sink, rectPoints, shape.color);
+                    break;
+            }
+        } else if constexpr (std::is_same_v<P, LayerCircle> || std::is_same_v<P, LayerEllipse>) {
+            if (shape.alg == FILL_RECURSIVE_FLOOD) {
+                Filling::RecursiveFloodFill(sink, shape.fillPoint.x, shape.fillPoint.y, shape.color);
+            } else if (shape.alg == FILL_NONRECURSIVE_FLOOD) {
+                Filling::NonRecursiveFloodFill(sink, shape.fillPoint.x, shape.fillPoint.y, shape.color);
+            }
+        }
+    }, target);
+}
+
+template <typename Sink>
+void LayerRenderer::RenderLayer(Sink& sink, const std::vector<Layer>& layers, const Layer& layer) {
+    std::visit([&](auto&& shape) {
+        using T = std::decay_t<decltype(shape)>;
+        if constexpr (std::is_same_v<T, LayerLine>) {
+            if (shape.alg == LINE_DDA)
+                Lines::LineBresenhamDDA(sink, shape.p1.x, shape.p1.y, shape.p2.x, shape.p2.y, shape.color);
+            else if (shape.alg == LINE_MIDPOINT)
+                Lines::DrawLineByMidPoint(sink, shape.p1.x, shape.p1.y, shape.p2.x, shape.p2.y, shape.color);
+        } else if constexpr (std::is_same_v<T, LayerCircle>) {
+            // Circles sharing a radius and algorithm replay one cached octant
+            CircleCache::Shared().Draw(sink, (CircleAlgorithm)shape.alg, shape.center.x, shape.center.y, shape.r, shape.color);
+        } else if constexpr (std::is_same_v<T, LayerEllipse>) {
+            if (shape.alg == ELLIPSE_DIRECT)
+                Ellipse::DrawEllipseEquation(sink, shape.center.x, shape.center.y, shape.a, shape.b, shape.color);
+            else if (shape.alg == ELLIPSE_POLAR)
+                Ellipse::DrawEllipsePolar(sink, shape.center.x, shape.center.y, shape.a, shape.b, shape.color);
+            else if (shape.alg == ELLIPSE_MIDPOINT)
+                Ellipse::DrawEllipseMidPoint(sink, shape.center.x, shape.center.y, shape.a, shape.b, shape.color);
+        } else if constexpr (std::is_same_v<T, LayerRect>) {
+            POINT rectPoints[5] = {
+                shape.p1,
+                {shape.p2.x, shape.p1.y},
+                shape.p2,
+                {shape.p1.x, shape.p2.y},
+                shape.p1
+            };
+            DrawPolygon(sink, std::vector<POINT>(rectPoints, rectPoints + 5), shape.color);
+        } else if constexpr (std::is_same_v<T, LayerPolygon>) {
+            if (shape.pts.size() >= 2) {
+                DrawPolygon(sink, shape.pts, shape.color);
+            }
+        } else if constexpr (std::is_same_v<T, LayerPoint>) {
+            sink.setPixel(shape.pt.x, shape.pt.y, shape.color);
+        } else if constexpr (std::is_same_v<T, LayerFill>) {
+            // The filled shape was resolved once, when the fill was created or loaded
+            if (shape.spans) {
+                shape.spans->Replay(sink, shape.color);
+            } else if (shape.target >= 0 && (size_t)shape.target < layers.size()) {
+                const LayerShape& target = layers[shape.target].shape;
+                if (shape.alg == FILL_RECURSIVE_FLOOD || shape.alg == FILL_NONRECURSIVE_FLOOD) {
+                    // Record the flooded pixels so later repaints skip the per-pixel search;
+                    // a fill that ran into the edge of the target depends on its size and is not kept
+                    SpanRecorder<Sink> recorder(sink);
+                    FillTarget(recorder, shape, target);
+                    if (!recorder.reachedEdge) {
+                        shape.spans = std::make_shared<const SpanMask>(SpanMask::FromPixels(recorder.pixels));
+                    }
+                } else {
+                    FillTarget(sink, shape, target);
+                }
+            }
+        } else if constexpr (std::is_same_v<T, LayerQuarterCircleFilling>) {
+            // Draw the circle boundary
+            SecondDegreeCurve::BresenhamCircle(sink, shape.center.x, shape.center.y, shape.radius, shape.color);
+            // Draw the filled quarter
+            Filling::FillQuarterWithSmallCircles(sink, shape.center.x, shape.center.y, shape.radius, shape.quarter, shape.color);
+        } else if constexpr (std::is_same_v<T, LayerRectangleBezierWaves>) {
+            // Draw rectangle boundary
+            POINT rectPoints[5] = {
+                shape.p1,
+                {shape.p2.x, shape.p1.y},
+                shape.p2,
+                {shape.p1.x, shape.p2.y},
+                shape.p1
+            };
+            DrawPolygon(sink, std::vector<POINT>(rectPoints, rectPoints + 5), shape.color);
+            // Fill with Bezier waves
+            Filling::FillRectangleWithBezierWaves(sink, shape.p1.x, shape.p1.y, shape.p2.x, shape.p2.y, shape.color);
+        } else if constexpr (std::is_same_v<T, LayerCircleQuarter>) {
+            SecondDegreeCurve::BresenhamCircle(sink, shape.center.x, shape.center.y, shape.radius, shape.color);
+            Filling::FillCircleQuarter(sink, shape.center.x, shape.center.y, shape.radius, shape.quarter, shape.color);
+        } else if constexpr (std::is_same_v<T, LayerSquareHermiteWaves>) {
+            // Draw square boundary
+            POINT pts[5] = {
+                shape.topLeft,
+                {shape.topLeft.x + shape.size, shape.topLeft.y},
+                {shape.topLeft.x + shape.size, shape.topLeft.y + shape.size},
+                {shape.topLeft.x, shape.topLeft.y + shape.size},
+                shape.topLeft
+            };
+            DrawPolygon(sink, std::vector<POINT>(pts, pts + 5), shape.color);
+            Filling::FillSquareWithVerticalHermiteWaves(sink, shape.topLeft.x, shape.topLeft.y, shape.size, shape.color);
+        } else if constexpr (std::is_same_v<T, LayerBezierCurve>) {
+            if (shape.alg == BEZIER_FLATTENED) {
+                std::vector<double> control = {(double)shape.p0.x, (double)shape.p0.y, (double)shape.p1.x, (double)shape.p1.y,
+                                               (double)shape.p2.x, (double)shape.p2.y, (double)shape.p3.x, (double)shape.p3.y};
+                ThirdDegreeCurve::FlatBezier(sink, control, shape.color);
+            } else {
+                ThirdDegreeCurve::BezierCurve(sink, shape.p0.x, shape.p0.y, shape.p1.x, shape.p1.y, shape.p2.x, shape.p2.y, shape.p3.x, shape.p3.y, shape.color);
+            }
+        } else if constexpr (std::is_same_v<T, LayerCardinalSpline>) {
+            if (shape.points.size() >= 8) {
+                ThirdDegreeCurve::CardinalSplines(sink, shape.points, 1, shape.color);
+            }
+        }
+    }, layer.shape);
+}
+
+inline void LayerRenderer::InvalidateFillCaches(const std::vector<Layer>& layers, size_t changed) {
+    for (size_t i = changed + 1; i < layers.size(); ++i) {
+        if (const LayerFill* fill = std::get_if<LayerFill>(&layers[i].shape)) {
+            fill->spans.reset();
+            fill->extent.reset();
+        }
+    }
+}
@@ -1,6 +1,10 @@
 // Header for lines.cpp
 #pragma once
-#include <windows.h>
+#include "platform.h"
+#include "pixel_sink.h"
+#include "common.h"
+#include <algorithm>
+#include <cstdlib>
 
 class Lines {
 public:
@@ -8,4 +12,107 @@ public:
     static void LineBresenhamDDA(HDC hdc, int x1, int y1, int x2, int y2, COLORREF c);
     static void DrawLineByMidPoint(HDC hdc, int x1, int y1, int x2, int y2, COLORREF c);
     static void DrawLineParametric(HDC hdc, int x1, int y1, int x2, int y2, COLORREF c);
+
+    // Sink-based versions (see pixel_sink.h); the HDC overloads forward to these
+    template <typename Sink>
+    static void InterpolatedColoredLine(Sink& sink, int x1, int y1, int x2, int y2, COLORREF c1, COLORREF c2);
+    template <typename Sink>
+    static void LineBresenhamDDA(Sink& sink, int x1, int y1, int x2, int y2, COLORREF c);
+    template <typename Sink>
+    static void DrawLineByMidPoint(Sink& sink, int x1, int y1, int x2, int y2, COLORREF c);
+    template <typename Sink>
+    static void DrawLineParametric(Sink& sink, int x1, int y1, int x2, int y2, COLORREF c);
 };
+
+template <typename Sink>
+void Lines::InterpolatedColoredLine(Sink& sink, int x1, int y1, int x2, int y2, COLORREF c1, COLORREF c2)
+{
+    int dx = x2 - x1;
+    int dy = y2 - y1;
+    double steps = 1.0 / std::max(abs(dx), abs(dy));
+    for (double t = 0; t <= 1; t += steps)
+    {
+        COLORREF c = Common::interpolateColors(c1, c2, t);
+        sink.setPixel(Common::Round(dx * t + x1), Common::Round(dy * t + y1), c);
+    }
+}
+
+template <typename Sink>
+void Lines::LineBresenhamDDA(Sink& sink, int x1, int y1, int x2, int y2, COLORREF c)
+{
+    int dx = abs(x2 - x1);
+    int dy = abs(y2 - y1);
+    int sx = (x2 > x1) ? 1 : -1;
+    int sy = (y2 > y1) ? 1 : -1;
+    int x = x1;
+    int y = y1;
+    sink.setPixel(x, y, c);
+    if (dx > dy)
+    {
+        int d = 2 * dy - dx;
+        int dE = 2 * dy;
+        int dNE = 2 * (dy - dx);
+        while (x != x2)
+        {
+            x += sx;
+            if (d < 0)
+            {
+                d += dE;
+            }
+            else
+            {
+                y += sy;
+                d += dNE;
+            }
+            sink.setPixel(x, y, c);
+        }
+    }
+    else
+    {
+        int d = 2 * dx - dy;
+        int dE = 2 * dx;
+        int dNE = 2 * (dx - dy);
+        while (y != y2)
+        {
+            y += sy;
+            if (d < 0)
+            {
+                d += dE;
+            }
+            else
+            {
+                x += sx;
+                d += dNE;
+            }
+            sink.setPixel(x, y, c);
+        }
+    }
+}
+
+template <typename Sink>
+void Lines::DrawLineByMidPoint(Sink& sink, int x1, int y1, int x2, int y2, COLORREF c)
+{
+    sink.setPixel(x1, y1, c);
+    sink.setPixel(x2, y2, c);
+    int avgX = Common::Round((x1 + x2) / 2);
+    int avgY = Common::Round((y1 + y2) / 2);
+    if ((x1 == avgX && y1 == avgY) || (x2 == avgX && avgY == y2))
+    {
+        return;
+    }
+    DrawLineByMidPoint(sink, x1, y1, avgX, avgY, c);
+    sink.setPixel(avgX, avgY, c);
+    DrawLineByMidPoint(sink, avgX, avgY, x2, y2, c);
+}
+
+template <typename Sink>
+void Lines::DrawLineParametric(Sink& sink, int x1, int y1, int x2, int y2, COLORREF c)
+{
+    int dx = x2 - x1;
+    int dy = y2 - y1;
+    double steps = 1.0 / std::max(abs(dx), abs(dy));
+    for (double t = 0; t <= 1; t += steps)
+    {
+        sink.setPixel(Common::Round(x1 + t * dx), Common::Round(y1 + t * dy), c);
+    }
+}
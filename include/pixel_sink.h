@@ -0,0 +1,175 @@
+// Pixel sinks: compile-time render targets for the rasterization algorithms
+#pragma once
+
+#include "platform.h"
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * Every drawing algorithm is a template over a Sink type that provides:
+ *   void     setPixel(int x, int y, COLORREF c);
+ *   COLORREF getPixel(int x, int y);   // CLR_INVALID outside the target
+ *   RECT     bounds();                  // writable area, right/bottom exclusive
+ *   void     fillSpan(int y, int x0, int x1, COLORREF c);   // row y, x0..x1 inclusive (x0 <= x1)
+ * Fills emit whole rows through fillSpan, so a target can store a run at once.
+ * The sink is resolved at compile time, so the per-pixel write is inlined
+ * instead of going through a function pointer or a GDI call.
+ */
+
+#ifdef _WIN32
+/**
+ * GdiSink - forwards pixels to a GDI device context (the classic SetPixel path).
+ */
+class GdiSink {
+public:
+    explicit GdiSink(HDC hdc) : hdc(hdc) {}
+
+    void setPixel(int x, int y, COLORREF c) { SetPixel(hdc, x, y, c); }
+    COLORREF getPixel(int x, int y) { return GetPixel(hdc, x, y); }
+    // One PatBlt with the DC brush instead of a SetPixel per pixel
+    void fillSpan(int y, int x0, int x1, COLORREF c) {
+        HGDIOBJ oldBrush = SelectObject(hdc, GetStockObject(DC_BRUSH));
+        SetDCBrushColor(hdc, c);
+        PatBlt(hdc, x0, y, x1 - x0 + 1, 1, PATCOPY);
+        SelectObject(hdc, oldBrush);
+    }
+    // The clip box: the update region during WM_PAINT, the bitmap for a memory DC
+    RECT bounds() const { RECT r; GetClipBox(hdc, &r); return r; }
+
+    HDC handle() const { return hdc; }
+
+private:
+    HDC hdc;
+};
+#endif
+
+/**
+ * FramebufferSink - writes into a caller-owned 32-bit pixel buffer.
+ * Pixels are stored as 0x00RRGGBB (the layout of a 32-bit DIB section and BMP files),
+ * so the buffer can be blitted or saved without conversion. Writes outside the buffer
+ * (or the optional clip rectangle) are dropped.
+ * @param stride Row pitch in pixels (not bytes).
+ */
+class FramebufferSink {
+public:
+    FramebufferSink(uint32_t* pixels, int width, int height, int stride)
+        : pixels(pixels), w(width), h(height), pitch(stride), clipLeft(0), clipTop(0), clipRight(width), clipBottom(height) {}
+    FramebufferSink(uint32_t* pixels, int width, int height)
+        : FramebufferSink(pixels, width, height, width) {}
+
+    void setPixel(int x, int y, COLORREF c) {
+        if (contains(x, y)) pixels[(size_t)y * pitch + x] = ToPixel(c);
+    }
+    COLORREF getPixel(int x, int y) const {
+        return contains(x, y) ? ToColor(pixels[(size_t)y * pitch + x]) : CLR_INVALID;
+    }
+    // Clipped row store; std::fill on 32-bit pixels compiles to a vectorized store loop
+    void fillSpan(int y, int x0, int x1, COLORREF c) {
+        if (y < clipTop || y >= clipBottom) return;
+        if (x0 < clipLeft) x0 = clipLeft;
+        if (x1 >= clipRight) x1 = clipRight - 1;
+        if (x0 > x1) return;
+        uint32_t* row = pixels + (size_t)y * pitch;
+        std::fill(row + x0, row + x1 + 1, ToPixel(c));
+    }
+
+    bool contains(int x, int y) const {
+        return x >= clipLeft && x < clipRight && y >= clipTop && y < clipBottom;
+    }
+
+    // Restricts reads and writes to [left, right) x [top, bottom); pixels outside behave as off-canvas
+    void setClip(int left, int top, int right, int bottom) {
+        clipLeft = left > 0 ? left : 0;
+        clipTop = top > 0 ? top : 0;
+        clipRight = right < w ? right : w;
+        clipBottom = bottom < h ? bottom : h;
+    }
+    void resetClip() { setClip(0, 0, w, h); }
+    RECT bounds() const { return RECT{clipLeft, clipTop, clipRight, clipBottom}; }
+
+    uint32_t* data() const { return pixels; }
+    int width() const { return w; }
+    int height() const { return h; }
+    int stride() const { return pitch; }
+
+    // COLORREF is 0x00BBGGRR; framebuffer pixels are 0x00RRGGBB
+    static uint32_t ToPixel(COLORREF c) {
+        return ((uint32_t)GetRValue(c) << 16) | ((uint32_t)GetGValue(c) << 8) | GetBValue(c);
+    }
+    static COLORREF ToColor(uint32_t p) {
+        return RGB((p >> 16) & 0xFF, (p >> 8) & 0xFF, p & 0xFF);
+    }
+
+private:
+    uint32_t* pixels;
+    int w, h, pitch;
+    int clipLeft, clipTop, clipRight, clipBottom;
+};
+
+/**
+ * CountingSink - decorator that counts pixel reads/writes and forwards them to another sink.
+ * Useful for measuring overdraw of an algorithm without changing it.
+ */
+template <typename Inner>
+class CountingSink {
+public:
+    explicit CountingSink(Inner& inner) : inner(inner) {}
+
+    void setPixel(int x, int y, COLORREF c) { ++writes; inner.setPixel(x, y, c); }
+    COLORREF getPixel(int x, int y) { ++reads; return inner.getPixel(x, y); }
+    RECT bounds() const { return inner.bounds(); }
+    void fillSpan(int y, int x0, int x1, COLORREF c) { ++spans; writes += x1 - x0 + 1; inner.fillSpan(y, x0, x1, c); }
+
+    size_t writes = 0; // pixels, including those written through spans
+    size_t reads = 0;
+    size_t spans = 0;
+
+private:
+    Inner& inner;
+};
+
+/**
+ * ClipSink - decorator that forwards only the pixels inside a rectangle (right/bottom exclusive):
+ * the inner sink's bounds, optionally narrowed further (e.g. to the Clipping window).
+ * Curve routines test their box against it up front and send only the reflections that can
+ * land on screen, instead of leaving the target to discard the rest one pixel at a time.
+ */
+template <typename Inner>
+class ClipSink {
+public:
+    explicit ClipSink(Inner& inner) : inner(inner), area(inner.bounds()) {}
+    ClipSink(Inner& inner, const RECT& limit) : ClipSink(inner) {
+        area.left = std::max(area.left, limit.left);
+        area.top = std::max(area.top, limit.top);
+        area.right = std::min(area.right, limit.right);
+        area.bottom = std::min(area.bottom, limit.bottom);
+    }
+
+    void setPixel(int x, int y, COLORREF c) {
+        if (contains(x, y)) inner.setPixel(x, y, c);
+    }
+    COLORREF getPixel(int x, int y) { return contains(x, y) ? inner.getPixel(x, y) : CLR_INVALID; }
+    RECT bounds() const { return area; }
+    void fillSpan(int y, int x0, int x1, COLORREF c) {
+        if (y < area.top || y >= area.bottom) return;
+        if (x0 < area.left) x0 = area.left;
+        if (x1 >= area.right) x1 = area.right - 1;
+        if (x0 <= x1) inner.fillSpan(y, x0, x1, c);
+    }
+
+    bool contains(int x, int y) const {
+        return x >= area.left && x < area.right && y >= area.top && y < area.bottom;
+    }
+    // The box [left, right] x [top, bottom] (inclusive) meets the area / lies entirely inside it
+    bool overlaps(long long left, long long top, long long right, long long bottom) const {
+        return left < area.right && right >= area.left && top < area.bottom && bottom >= area.top && left <= right && top <= bottom;
+    }
+    bool covers(long long left, long long top, long long right, long long bottom) const {
+        return left >= area.left && right < area.right && top >= area.top && bottom < area.bottom;
+    }
+
+private:
+    Inner& inner;
+    RECT area;
+};
@@ -0,0 +1,29 @@
+// Platform shim: real Win32 headers on Windows, a minimal subset elsewhere
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+// Only the plain data types and color macros the rasterizers need are provided here,
+// so the algorithms can be compiled and run headless (e.g. on Linux render boxes).
+// GDI entry points are intentionally not declared; HDC/HWND are opaque handles.
+#include <cstdint>
+
+typedef long LONG;
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef DWORD COLORREF;
+
+struct POINT { LONG x, y; };
+struct RECT { LONG left, top, right, bottom; };
+
+typedef struct HDC__* HDC;
+typedef struct HWND__* HWND;
+
+#define RGB(r, g, b) ((COLORREF)(((BYTE)(r) | ((WORD)((BYTE)(g)) << 8)) | (((DWORD)(BYTE)(b)) << 16)))
+#define GetRValue(rgb) ((BYTE)(rgb))
+#define GetGValue(rgb) ((BYTE)(((WORD)(rgb)) >> 8))
+#define GetBValue(rgb) ((BYTE)((rgb) >> 16))
+#define CLR_INVALID 0xFFFFFFFF
+#endif
@@ -0,0 +1,71 @@
+// Run-length span masks: a pixel region stored as horizontal runs per row
+#pragma once
+#include "platform.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * SpanMask - a set of pixels stored as per-row runs [x0, x1] (inclusive), sorted by row then x.
+ * Used to record the result of an expensive fill once and replay it as horizontal runs.
+ */
+class SpanMask {
+public:
+    struct Span { int y, x0, x1; };
+
+    // Builds the mask from unordered pixel coordinates (sorted in place, duplicates allowed)
+    static SpanMask FromPixels(std::vector<POINT>& pixels);
+
+    const std::vector<Span>& spans() const { return runs; }
+    size_t pixelCount() const;
+    bool empty() const { return runs.empty(); }
+
+    // Paints every pixel of the mask, moved by (dx, dy), with `color`, without reading the sink
+    template <typename Sink>
+    void Replay(Sink& sink, COLORREF color, int dx = 0, int dy = 0) const;
+
+private:
+    std::vector<Span> runs;
+};
+
+/**
+ * SpanRecorder - decorator that forwards to another sink and remembers every written pixel.
+ * `reachedEdge` is set when the algorithm wrote on the border of the target's bounds or read
+ * outside them (CLR_INVALID); such a result may have been cut by the target size and must not
+ * be reused elsewhere.
+ */
+template <typename Inner>
+class SpanRecorder {
+public:
+    explicit SpanRecorder(Inner& inner) : inner(inner), area(inner.bounds()) {}
+
+    void setPixel(int x, int y, COLORREF c) {
+        if (x <= area.left || x >= area.right - 1 || y <= area.top || y >= area.bottom - 1) reachedEdge = true;
+        pixels.push_back(POINT{x, y});
+        inner.setPixel(x, y, c);
+    }
+    COLORREF getPixel(int x, int y) {
+        COLORREF c = inner.getPixel(x, y);
+        if (c == CLR_INVALID) reachedEdge = true;
+        return c;
+    }
+    RECT bounds() const { return area; }
+    void fillSpan(int y, int x0, int x1, COLORREF c) {
+        if (x0 <= area.left || x1 >= area.right - 1 || y <= area.top || y >= area.bottom - 1) reachedEdge = true;
+        for (int x = x0; x <= x1; ++x) pixels.push_back(POINT{x, y});
+        inner.fillSpan(y, x0, x1, c);
+    }
+
+    std::vector<POINT> pixels;
+    bool reachedEdge = false;
+
+private:
+    Inner& inner;
+    RECT area;
+};
+
+template <typename Sink>
+void SpanMask::Replay(Sink& sink, COLORREF color, int dx, int dy) const {
+    for (const Span& s : runs) {
+        sink.fillSpan(s.y + dy, s.x0 + dx, s.x1 + dx, color);
+    }
+}
@@ -1,12 +1,14 @@
 #ifndef STORAGE_H
 #define STORAGE_H
 
-#include <windows.h>
+#include "platform.h"
 #include <vector>
 #include <string>
+#include <ostream>
 
 // Forward declarations
 struct Layer;
+class FramebufferSink;
 
 /**
  * Storage class for saving and loading graphics project data
@@ -33,6 +35,10 @@ public:
     // New methods for saving/loading layers
     static bool saveLayersToFile(const std::vector<Layer>& layers, const std::string& path);
     static bool loadLayersFromFile(std::vector<Layer>& layers, const std::string& path);
+
+    // Rendered image export (headless renderer)
+    static bool writePPM(std::ostream& out, const FramebufferSink& fb);
+    static bool writeBMP(std::ostream& out, const FramebufferSink& fb);
 };
 
 #endif // STORAGE_H
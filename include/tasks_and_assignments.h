@@ -1,9 +1,72 @@
 // Header for tasks_and_assignments.cpp
 #pragma once
-#include <windows.h>
+#include "platform.h"
+#include "pixel_sink.h"
+#include "common.h"
+#include "lines.h"
+#include "curves_second_degree.h"
+#include <utility>
+#include <vector>
 
 class TasksAndAssignments {
 public:
     static void pizzaCircle(HDC hdc, int xc, int yc, int r, COLORREF c);
     static void BezierInterpolatedCurve(HDC hdc, int x1, int y1, COLORREF c1, int x2, int y2, COLORREF c2, int x3, int y3, COLORREF c3, int x4, int y4, COLORREF c4);
+
+    // Sink-based versions (see pixel_sink.h); the HDC overloads forward to these
+    template <typename Sink>
+    static void pizzaCircle(Sink& sink, int xc, int yc, int r, COLORREF c);
+    template <typename Sink>
+    static void BezierInterpolatedCurve(Sink& sink, int x1, int y1, COLORREF c1, int x2, int y2, COLORREF c2, int x3, int y3, COLORREF c3, int x4, int y4, COLORREF c4);
 };
+
+template <typename Sink>
+void TasksAndAssignments::pizzaCircle(Sink& sink, int xc, int yc, int r, COLORREF c)
+{
+    int x = 0, y = r;
+
+    // Draw line vertical and horizontal
+    Lines::LineBresenhamDDA(sink, xc - r, yc, xc + r, yc, c);
+    Lines::LineBresenhamDDA(sink, xc, yc - r, xc, yc + r, c);
+
+    // Draw circle by bresenham
+    std::pair<int, int> point = SecondDegreeCurve::BresenhamCircle(sink, xc, yc, r, c);
+    x = point.first;
+    y = point.second;
+
+    Lines::LineBresenhamDDA(sink, xc - x, yc - y, xc + x, yc + y, c);
+    Lines::LineBresenhamDDA(sink, xc + x, yc - y, xc - x, yc + y, c);
+}
+
+template <typename Sink>
+void TasksAndAssignments::BezierInterpolatedCurve(Sink& sink, int x1, int y1, COLORREF c1, int x2, int y2, COLORREF c2, int x3, int y3, COLORREF c3, int x4, int y4, COLORREF c4)
+{
+    Vec4 Gx = {{x1, x2, x3, x4}}; // 4x1
+    Vec4 Gy = {{y1, y2, y3, y4}}; // 4x1
+
+    // Multiply the Bezier basis (4x4) * Gx/Gy (4x1) => 4x1
+    Vec4 Cx = Common::matrixMult(CurveBasis::Bezier, Gx);
+    Vec4 Cy = Common::matrixMult(CurveBasis::Bezier, Gy);
+
+    for (double t = 0; t <= 1.0; t += 0.0001)
+    {
+        double t2 = t * t;
+        double t3 = t2 * t;
+        int x = Common::Round(Cx[0] * t3 + Cx[1] * t2 + Cx[2] * t + Cx[3]);
+        int y = Common::Round(Cy[0] * t3 + Cy[1] * t2 + Cy[2] * t + Cy[3]);
+        COLORREF c;
+        if (t < 1.0 / 3)
+        {
+            c = Common::interpolateColors(c1, c2, t);
+        }
+        else if (t > 1.0 / 3 && t < 2.0 / 3)
+        {
+            c = Common::interpolateColors(c2, c3, t);
+        }
+        else if (t > 2.0 / 3 && t < 1.0)
+        {
+            c = Common::interpolateColors(c3, c4, t);
+        }
+        sink.setPixel(x, y, c);
+    }
+}
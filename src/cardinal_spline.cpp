@@ -0,0 +1,74 @@
+#include "../include/cardinal_spline.h"
+#include "../include/curves_third_degree.h"
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+void CardinalSpline::assign(const vector<double>& points) {
+    pts.assign(points.begin(), points.end() - points.size() % 2);
+    segments.assign(pointCount() > 0 ? pointCount() - 1 : 0, Segment());
+    for (size_t i = 0; i < segments.size(); i++) Flatten(i);
+}
+
+void CardinalSpline::append(double x, double y) {
+    pts.push_back(x);
+    pts.push_back(y);
+    if (pointCount() < 2) return;
+    segments.push_back(Segment());
+    // The previous end point now has a neighbour on both sides, which changes its tangent
+    size_t last = segments.size() - 1;
+    if (last > 0) Flatten(last - 1);
+    Flatten(last);
+}
+
+void CardinalSpline::clear() {
+    pts.clear();
+    segments.clear();
+}
+
+void CardinalSpline::setTension(double tension) {
+    c = tension;
+    for (size_t i = 0; i < segments.size(); i++) Flatten(i);
+}
+
+void CardinalSpline::Tangent(size_t i, double& tx, double& ty) const {
+    size_t prev = i > 0 ? i - 1 : i;
+    size_t next = i + 1 < pointCount() ? i + 1 : i;
+    tx = c * (pts[2 * next] - pts[2 * prev]) / 2.0;
+    ty = c * (pts[2 * next + 1] - pts[2 * prev + 1]) / 2.0;
+}
+
+void CardinalSpline::Flatten(size_t i) {
+    // The Hermite segment as a Bezier curve: p[i], p[i] + t[i]/3, p[i+1] - t[i+1]/3, p[i+1]
+    double t0x, t0y, t1x, t1y;
+    Tangent(i, t0x, t0y);
+    Tangent(i + 1, t1x, t1y);
+    double x0 = pts[2 * i], y0 = pts[2 * i + 1], x1 = pts[2 * i + 2], y1 = pts[2 * i + 3];
+    vector<double> control = {x0, y0, x0 + t0x / 3, y0 + t0y / 3, x1 - t1x / 3, y1 - t1y / 3, x1, y1};
+
+    Segment& s = segments[i];
+    ThirdDegreeCurve::FlattenBezier(control, s.polyline);
+    // The lines drawn between the vertices stay inside the vertices' box
+    LONG left = s.polyline[0].x, right = left, top = s.polyline[0].y, bottom = top;
+    for (const POINT& p : s.polyline) {
+        left = min(left, p.x);
+        right = max(right, p.x);
+        top = min(top, p.y);
+        bottom = max(bottom, p.y);
+    }
+    s.bounds = RECT{left - 1, top - 1, right + 2, bottom + 2};
+    ++flattened;
+}
+
+// GDI entry points: forward to the sink-based templates in cardinal_spline.h
+#ifdef _WIN32
+void CardinalSpline::Draw(HDC hdc, COLORREF color) const {
+    GdiSink sink(hdc);
+    Draw(sink, color);
+}
+
+void CardinalSpline::Draw(HDC hdc, COLORREF color, const RECT& area) const {
+    GdiSink sink(hdc);
+    Draw(sink, color, area);
+}
+#endif
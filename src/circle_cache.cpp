@@ -0,0 +1,86 @@
+#include "../include/circle_cache.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <vector>
+using namespace std;
+
+// Keeps the first-octant representative (0 <= x <= y) of every pixel drawn around (0, 0)
+struct OctantCollector {
+    vector<POINT> points;
+    void setPixel(int x, int y, COLORREF) {
+        int a = abs(x), b = abs(y);
+        points.push_back(POINT{min(a, b), max(a, b)});
+    }
+    void fillSpan(int y, int x0, int x1, COLORREF c) {
+        for (int x = x0; x <= x1; x++) setPixel(x, y, c);
+    }
+    RECT bounds() const { return RECT{INT_MIN, INT_MIN, INT_MAX, INT_MAX}; }
+};
+
+CircleCache& CircleCache::Shared() {
+    static thread_local CircleCache cache;
+    return cache;
+}
+
+void CircleCache::setBudget(size_t bytes) {
+    budgetBytes = bytes;
+    EvictTo(budgetBytes);
+}
+
+void CircleCache::clear() {
+    entries.clear();
+    index.clear();
+    usedBytes = 0;
+}
+
+void CircleCache::EvictTo(size_t bytes) {
+    while (usedBytes > bytes && !entries.empty()) {
+        usedBytes -= Cost(entries.back());
+        index.erase(entries.back().key);
+        entries.pop_back();
+        ++evictions;
+    }
+}
+
+const vector<POINT>* CircleCache::Octant(CircleAlgorithm alg, int r) {
+    Key key(alg, r);
+    auto found = index.find(key);
+    if (found != index.end()) {
+        ++hits;
+        entries.splice(entries.begin(), entries, found->second);
+        return &entries.front().octant;
+    }
+    ++misses;
+
+    // The octant spans x = 0..r/sqrt(2), about one point per column, so a circle that cannot
+    // fit is known before it is rasterized
+    long long extent = r < 0 ? -(long long)r : r;
+    size_t estimate = ((size_t)(extent * 0.70710678118654752) + 1) * sizeof(POINT);
+    if (estimate > budgetBytes) return nullptr;
+
+    OctantCollector collector;
+    Rasterize(collector, alg, 0, 0, r, 0);
+    vector<POINT>& points = collector.points;
+    sort(points.begin(), points.end(), [](const POINT& a, const POINT& b) {
+        return a.x != b.x ? a.x < b.x : a.y < b.y;
+    });
+    points.erase(unique(points.begin(), points.end()), points.end());
+
+    Entry entry = {key, std::move(points)};
+    size_t cost = Cost(entry);
+    if (cost > budgetBytes) return nullptr;
+    EvictTo(budgetBytes - cost);
+    entries.push_front(std::move(entry));
+    index[key] = entries.begin();
+    usedBytes += cost;
+    return &entries.front().octant;
+}
+
+// GDI entry point: forwards to the sink-based template in circle_cache.h
+#ifdef _WIN32
+void CircleCache::Draw(HDC hdc, CircleAlgorithm alg, int xc, int yc, int r, COLORREF c) {
+    GdiSink sink(hdc);
+    Draw(sink, alg, xc, yc, r, c);
+}
+#endif
@@ -1,4 +1,4 @@
-#include <windows.h>
+#include "../include/platform.h"
 #include <algorithm>
 #include <limits.h>
 #include <vector>
@@ -89,102 +89,34 @@ std::vector<POINT> Clipping::SutherlandHodgmanClip(const POINT* input, int n) {
     return poly;
 }
 
-void Clipping::ClippingPolygon(HDC hdc, const POINT* points, int n, COLORREF color) {
-    if (n < 3) return;
-    
-    std::vector<POINT> clipped = SutherlandHodgmanClip(points, n);
-    if (clipped.size() < 3) return;
+int Clipping::computeCode(int x, int y) {
+    int code = INSIDE;
+    if (x < CLIP_X_MIN) code |= LEFT;
+    else if (x > CLIP_X_MAX) code |= RIGHT;
+    if (y < CLIP_Y_MIN) code |= BOTTOM;
+    else if (y > CLIP_Y_MAX) code |= TOP;
+    return code;
+}
 
-    HPEN hPen = CreatePen(PS_SOLID, 1, color);
-    HGDIOBJ oldPen = SelectObject(hdc, hPen);
-    
-    // Draw the clipped polygon
-    MoveToEx(hdc, clipped[0].x, clipped[0].y, NULL);
-    for (size_t i = 1; i < clipped.size(); ++i) {
-        LineTo(hdc, clipped[i].x, clipped[i].y);
-    }
-    LineTo(hdc, clipped[0].x, clipped[0].y); // Close the polygon
-    
-    SelectObject(hdc, oldPen);
-    DeleteObject(hPen);
+// GDI entry points: forward to the sink-based templates in clipping.h
+#ifdef _WIN32
+void Clipping::ClippingPolygon(HDC hdc, const POINT* points, int n, COLORREF color) {
+    GdiSink sink(hdc);
+    ClippingPolygon(sink, points, n, color);
 }
 
-/**
- * @brief Draws a line with clipping using the Cohen-Sutherland algorithm.
- * @param hdc Handle to the device context.
- * @param x1 The x-coordinate of the first point.
- * @param y1 The y-coordinate of the first point.
- * @param x2 The x-coordinate of the second point.
- * @param y2 The y-coordinate of the second point.
- * @param color The color of the line.
- * This function implements the Cohen-Sutherland line clipping algorithm to draw a line segment within a clipping window.
- */
 void Clipping::ClippingLine(HDC hdc, int x1, int y1, int x2, int y2, COLORREF color) {
-    int code1 = computeCode(x1, y1);
-    int code2 = computeCode(x2, y2);
-    bool accept = false;
-    
-    while (true) {
-        if ((code1 | code2) == 0) {
-            // Both endpoints inside
-            accept = true;
-            break;
-        } else if (code1 & code2) {
-            // Both endpoints share an outside zone
-            break;
-        } else {
-            int codeOut = code1 ? code1 : code2;
-            int x, y;
-            
-            if (codeOut & TOP) {
-                x = x1 + (x2 - x1) * (CLIP_Y_MAX - y1) / (y2 - y1);
-                y = CLIP_Y_MAX;
-            } else if (codeOut & BOTTOM) {
-                x = x1 + (x2 - x1) * (CLIP_Y_MIN - y1) / (y2 - y1);
-                y = CLIP_Y_MIN;
-            } else if (codeOut & RIGHT) {
-                y = y1 + (y2 - y1) * (CLIP_X_MAX - x1) / (x2 - x1);
-                x = CLIP_X_MAX;
-            } else { // LEFT
-                y = y1 + (y2 - y1) * (CLIP_X_MIN - x1) / (x2 - x1);
-                x = CLIP_X_MIN;
-            }
-            
-            if (codeOut == code1) {
-                x1 = x; y1 = y; code1 = computeCode(x1, y1);
-            } else {
-                x2 = x; y2 = y; code2 = computeCode(x2, y2);
-            }
-        }
-    }
-    
-    if (accept) {
-        HPEN hPen = CreatePen(PS_SOLID, 1, color);
-        HGDIOBJ oldPen = SelectObject(hdc, hPen);
-        MoveToEx(hdc, x1, y1, NULL);
-        LineTo(hdc, x2, y2);
-        SelectObject(hdc, oldPen);
-        DeleteObject(hPen);
-    }
+    GdiSink sink(hdc);
+    ClippingLine(sink, x1, y1, x2, y2, color);
 }
 
 void Clipping::ClipPointSquare(HDC hdc, int x, int y, COLORREF color) {
-    if (x >= CLIP_X_MIN && x <= CLIP_X_MAX && y >= CLIP_Y_MIN && y <= CLIP_Y_MAX) {
-        SetPixel(hdc, x, y, color);
-    }
+    GdiSink sink(hdc);
+    ClipPointSquare(sink, x, y, color);
 }
 
 void Clipping::Clippingpoint(HDC hdc, int x, int y, COLORREF color) {
-    if (x >= CLIP_X_MIN && x <= CLIP_X_MAX && y >= CLIP_Y_MIN && y <= CLIP_Y_MAX) {
-        SetPixel(hdc, x, y, color);
-    }
-}
-
-int Clipping::computeCode(int x, int y) {
-    int code = INSIDE;
-    if (x < CLIP_X_MIN) code |= LEFT;
-    else if (x > CLIP_X_MAX) code |= RIGHT;
-    if (y < CLIP_Y_MIN) code |= BOTTOM;
-    else if (y > CLIP_Y_MAX) code |= TOP;
-    return code;
+    GdiSink sink(hdc);
+    Clippingpoint(sink, x, y, color);
 }
+#endif
@@ -7,6 +7,19 @@ int Common::Round(double x)
     return (int)(x + 0.5);
 }
 
+long long Common::ISqrt(long long v)
+{
+    if (v <= 0)
+        return 0;
+    // The double root is within one of the answer; step onto it in integers
+    long long s = (long long)std::sqrt((double)v);
+    while (s > 0 && s > v / s)
+        s--;
+    while (s + 1 <= v / (s + 1))
+        s++;
+    return s;
+}
+
 COLORREF Common::interpolateColors(COLORREF c1, COLORREF c2, double t)
 {
     int r = Round(GetRValue(c1) * t + (1 - t) * GetRValue(c2));
@@ -15,27 +28,6 @@ COLORREF Common::interpolateColors(COLORREF c1, COLORREF c2, double t)
     return RGB(r, g, b);
 }
 
-std::vector<int> Common::matrixMult(std::vector<std::vector<int>> m1, std::vector<int> m2)
-{
-    int rows = m1.size();
-    int shared = m1[0].size(); // should be equal to m2.size()
-    int cols = m2.size();
-
-    std::vector<int> result(rows, 0);
-
-    for (int i = 0; i < rows; ++i)
-    {
-        // for (int k = 0; k < cols; ++k) {
-        for (int j = 0; j < shared; ++j)
-        {
-            result[i] += m1[i][j] * m2[j];
-        }
-        //}
-    }
-
-    return result;
-}
-
 bool Common::isValidPolygon(const std::vector<POINT>& points) {
     if (points.size() < 2) return true; // Need at least two points to check distance
 
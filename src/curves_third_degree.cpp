@@ -1,89 +1,150 @@
 #include "../include/curves_third_degree.h"
 #include "../include/common.h"
+#include <algorithm>
+#include <cmath>
 #include <vector>
 using namespace std;
 
-void ThirdDegreeCurve::HermiteCurve(HDC hdc, int x1, int y1, int u1, int v1, int x2, int y2, int u2, int v2, COLORREF c) {
-    vector<vector<int>> H = {
-        {2, -2, 1, 1},
-        {-3, 3, -2, -1},
-        {0, 0, 1, 0},
-        {1, 0, 0, 0}};
-    vector<int> Gx = {x1, x2, u1, u2};
-    vector<int> Gy = {y1, y2, v1, v2};
-    vector<int> Cx = Common::matrixMult(H, Gx);
-    vector<int> Cy = Common::matrixMult(H, Gy);
-    for (double t = 0; t <= 1.0; t += 0.0001) {
-        double t2 = t * t;
-        double t3 = t2 * t;
-        int x = Common::Round(Cx[0] * t3 + Cx[1] * t2 + Cx[2] * t + Cx[3]);
-        int y = Common::Round(Cy[0] * t3 + Cy[1] * t2 + Cy[2] * t + Cy[3]);
-        SetPixel(hdc, x, y, c);
-    }
+// Control points scaled by their binomial coefficients, kept per thread so repeated evaluation does not allocate
+struct BernsteinScratch {
+    vector<double> qx, qy;
+};
+
+static BernsteinScratch& BezierScratch() {
+    static thread_local BernsteinScratch scratch;
+    return scratch;
 }
 
-void ThirdDegreeCurve::BezierCurve(HDC hdc, int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4, COLORREF c) {
-    vector<vector<int>> H = {
-        {-1, 3, -3, 1},
-        {3, -6, 3, 0},
-        {-3, 3, 0, 0},
-        {1, 0, 0, 0}};
-    vector<int> Gx = {x1, x2, x3, x4};
-    vector<int> Gy = {y1, y2, y3, y4};
-    vector<int> Cx = Common::matrixMult(H, Gx);
-    vector<int> Cy = Common::matrixMult(H, Gy);
-    for (double t = 0; t <= 1.0; t += 0.0001) {
-        double t2 = t * t;
-        double t3 = t2 * t;
-        int x = Common::Round(Cx[0] * t3 + Cx[1] * t2 + Cx[2] * t + Cx[3]);
-        int y = Common::Round(Cy[0] * t3 + Cy[1] * t2 + Cy[2] * t + Cy[3]);
-        SetPixel(hdc, x, y, c);
+/**
+ * B(t) = sum C(n,k) t^k (1-t)^(n-k) P_k. For t < 1/2 it is (1-t)^n * sum Q_k u^k with u = t/(1-t),
+ * otherwise t^n * sum Q_k u^(n-k) with u = (1-t)/t, so u <= 1 and Horner's rule stays stable.
+ * The lanes are independent and only select between broadcast coefficients, so the loops vectorize.
+ */
+static void BernsteinLanes(const double* qx, const double* qy, int n, const double* t, int count, double* x, double* y) {
+    const int L = ThirdDegreeCurve::BEZIER_LANES;
+    double u[L], base[L], scale[L], ax[L], ay[L];
+    bool low[L];
+    for (int i = 0; i < L; i++) {
+        double ti = i < count ? t[i] : 0;
+        double si = 1 - ti;
+        low[i] = ti < 0.5;
+        u[i] = low[i] ? ti / si : si / ti;
+        base[i] = low[i] ? si : ti;
+        scale[i] = 1;
+        ax[i] = low[i] ? qx[n] : qx[0];
+        ay[i] = low[i] ? qy[n] : qy[0];
+    }
+    for (int j = 1; j <= n; j++) {
+        for (int i = 0; i < L; i++) {
+            ax[i] = ax[i] * u[i] + (low[i] ? qx[n - j] : qx[j]);
+            ay[i] = ay[i] * u[i] + (low[i] ? qy[n - j] : qy[j]);
+            scale[i] *= base[i];
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        x[i] = ax[i] * scale[i];
+        y[i] = ay[i] * scale[i];
     }
 }
 
-vector<double> ThirdDegreeCurve::Bezier(vector<double> points, double t) {
-    if (points.size() == 2)
-        return {points[0], points[1]};
-    vector<double> newPoints;
-    for (int i = 0; i < points.size() - 2; i += 2) {
-        double x = (1 - t) * points[i] + t * points[i + 2];
-        double y = (1 - t) * points[i + 1] + t * points[i + 3];
-        newPoints.push_back(x);
-        newPoints.push_back(y);
+void ThirdDegreeCurve::EvaluateBezier(const vector<double>& points, const double* t, size_t count, double* x, double* y) {
+    int n = (int)(points.size() / 2) - 1;
+    if (n < 0) return;
+    BernsteinScratch& scratch = BezierScratch();
+    scratch.qx.resize(n + 1);
+    scratch.qy.resize(n + 1);
+    double binomial = 1;
+    for (int k = 0; k <= n; k++) {
+        scratch.qx[k] = binomial * points[2 * k];
+        scratch.qy[k] = binomial * points[2 * k + 1];
+        binomial = binomial * (n - k) / (k + 1);
+    }
+    for (size_t first = 0; first < count; first += BEZIER_LANES) {
+        int lanes = count - first < (size_t)BEZIER_LANES ? (int)(count - first) : BEZIER_LANES;
+        BernsteinLanes(scratch.qx.data(), scratch.qy.data(), n, t + first, lanes, x + first, y + first);
     }
-    return Bezier(newPoints, t);
 }
 
-void ThirdDegreeCurve::RecBezier(HDC hdc, vector<double> points, COLORREF c) {
-    for (double t = 0; t < 1; t += 0.00005) {
-        vector<double> point = Bezier(points, t);
-        SetPixel(hdc, point[0], point[1], c);
-    }
+vector<double> ThirdDegreeCurve::Bezier(const vector<double>& points, double t) {
+    double x = 0, y = 0;
+    EvaluateBezier(points, &t, 1, &x, &y);
+    return {x, y};
 }
 
-void ThirdDegreeCurve::CardinalSplines(HDC hdc, vector<double> points, int C, COLORREF color)
-{
-    int n = points.size() / 2;
-    if (n < 4) return; // Need at least 4 points
+// Largest distance of the inner control points from the chord segment between the end points
+static double HullFlatness(const vector<double>& p) {
+    size_t n = p.size() / 2;
+    double x0 = p[0], y0 = p[1];
+    double dx = p[2 * n - 2] - x0, dy = p[2 * n - 1] - y0;
+    double length2 = dx * dx + dy * dy;
+    double flatness = 0;
+    for (size_t i = 1; i + 1 < n; i++) {
+        double px = p[2 * i] - x0, py = p[2 * i + 1] - y0;
+        // Distance to the chord segment, not its line: a control point past either end pulls
+        // the curve beyond the chord even when it is collinear with it
+        double t = length2 > 0 ? (px * dx + py * dy) / length2 : 0;
+        t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        flatness = max(flatness, hypot(px - t * dx, py - t * dy));
+    }
+    return flatness;
+}
 
-    // Calculate tangents
-    vector<double> qx, qy;
-    for (int i = 0; i < n; i++) {
-        if (i == 0 || i == n - 1) {
-            qx.push_back(0);
-            qy.push_back(0);
-        } else {
-            qx.push_back(C * (points[2 * (i + 1)] - points[2 * (i - 1)]) / 2.0);
-            qy.push_back(C * (points[2 * (i + 1) + 1] - points[2 * (i - 1) + 1]) / 2.0);
-        }
+// Appends the end point of each flat enough piece of the curve, left to right
+static void Flatten(const vector<double>& p, double tolerance, int depth, vector<POINT>& polyline) {
+    if (depth == 0 || HullFlatness(p) <= tolerance) {
+        POINT end = {Common::Round(p[p.size() - 2]), Common::Round(p[p.size() - 1])};
+        if (end.x != polyline.back().x || end.y != polyline.back().y) polyline.push_back(end);
+        return;
     }
-    // Draw Hermite curves between each pair of points
-    for (int i = 1; i < n - 2; i++) {
-        HermiteCurve(
-            hdc,
-            (int)points[2 * i], (int)points[2 * i + 1], (int)qx[i], (int)qy[i],
-            (int)points[2 * (i + 1)], (int)points[2 * (i + 1) + 1], (int)qx[i + 1], (int)qy[i + 1],
-            color
-        );
+    // de Casteljau at t = 1/2: the halves' control points are the first and last points of each level
+    size_t n = p.size() / 2;
+    vector<double> level(p), left(p.size()), right(p.size());
+    for (size_t k = 0; k < n; k++) {
+        size_t m = n - k;
+        left[2 * k] = level[0];
+        left[2 * k + 1] = level[1];
+        right[2 * (m - 1)] = level[2 * (m - 1)];
+        right[2 * (m - 1) + 1] = level[2 * (m - 1) + 1];
+        for (size_t i = 0; i + 1 < m; i++) {
+            level[2 * i] = (level[2 * i] + level[2 * i + 2]) / 2;
+            level[2 * i + 1] = (level[2 * i + 1] + level[2 * i + 3]) / 2;
+        }
     }
-}
\ No newline at end of file
+    Flatten(left, tolerance, depth - 1, polyline);
+    Flatten(right, tolerance, depth - 1, polyline);
+}
+
+void ThirdDegreeCurve::FlattenBezier(const vector<double>& points, vector<POINT>& polyline, double tolerance) {
+    polyline.clear();
+    if (points.size() < 2) return;
+    polyline.push_back(POINT{Common::Round(points[0]), Common::Round(points[1])});
+    if (points.size() >= 4) Flatten(points, max(tolerance, 0.01), BEZIER_MAX_DEPTH, polyline);
+}
+
+// GDI entry points: forward to the sink-based templates in curves_third_degree.h
+#ifdef _WIN32
+void ThirdDegreeCurve::HermiteCurve(HDC hdc, int x1, int y1, int u1, int v1, int x2, int y2, int u2, int v2, COLORREF c) {
+    GdiSink sink(hdc);
+    HermiteCurve(sink, x1, y1, u1, v1, x2, y2, u2, v2, c);
+}
+
+void ThirdDegreeCurve::BezierCurve(HDC hdc, int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4, COLORREF c) {
+    GdiSink sink(hdc);
+    BezierCurve(sink, x1, y1, x2, y2, x3, y3, x4, y4, c);
+}
+
+void ThirdDegreeCurve::RecBezier(HDC hdc, vector<double> points, COLORREF c) {
+    GdiSink sink(hdc);
+    RecBezier(sink, points, c);
+}
+
+void ThirdDegreeCurve::CardinalSplines(HDC hdc, vector<double> points, int C, COLORREF color) {
+    GdiSink sink(hdc);
+    CardinalSplines(sink, points, C, color);
+}
+
+void ThirdDegreeCurve::FlatBezier(HDC hdc, const vector<double>& points, COLORREF c, double tolerance) {
+    GdiSink sink(hdc);
+    FlatBezier(sink, points, c, tolerance);
+}
+#endif
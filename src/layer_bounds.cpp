@@ -0,0 +1,177 @@
+#include "../include/layer_bounds.h"
+#include "../include/curves_third_degree.h"
+#include "../include/filling.h"
+#include "../include/layer_renderer.h"
+#include "../include/span_mask.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <variant>
+
+const RECT LayerBounds::Empty = {0, 0, 0, 0};
+// Halved limits so width/height computations can't overflow
+const RECT LayerBounds::Everything = {INT_MIN / 2, INT_MIN / 2, INT_MAX / 2, INT_MAX / 2};
+
+RECT LayerBounds::OfPoints(const POINT* points, size_t n, int margin) {
+    if (n == 0) return Empty;
+    LONG minX = points[0].x, maxX = points[0].x;
+    LONG minY = points[0].y, maxY = points[0].y;
+    for (size_t i = 1; i < n; ++i) {
+        minX = std::min(minX, points[i].x);
+        maxX = std::max(maxX, points[i].x);
+        minY = std::min(minY, points[i].y);
+        maxY = std::max(maxY, points[i].y);
+    }
+    return RECT{minX - margin, minY - margin, maxX + 1 + margin, maxY + 1 + margin};
+}
+
+RECT LayerBounds::FromCenter(POINT center, int rx, int ry, int margin) {
+    rx = std::abs(rx);
+    ry = std::abs(ry);
+    return RECT{center.x - rx - margin, center.y - ry - margin, center.x + rx + 1 + margin, center.y + ry + 1 + margin};
+}
+
+RECT LayerBounds::OfShape(const LayerShape& shape) {
+    return std::visit([](auto&& s) -> RECT {
+        using T = std::decay_t<decltype(s)>;
+        if constexpr (std::is_same_v<T, LayerLine>) {
+            POINT pts[2] = {s.p1, s.p2};
+            return OfPoints(pts, 2, 1);
+        } else if constexpr (std::is_same_v<T, LayerCircle>) {
+            return FromCenter(s.center, s.r, s.r, 1);
+        } else if constexpr (std::is_same_v<T, LayerEllipse>) {
+            return FromCenter(s.center, s.a, s.b, 1);
+        } else if constexpr (std::is_same_v<T, LayerRect>) {
+            POINT pts[2] = {s.p1, s.p2};
+            return OfPoints(pts, 2, 1);
+        } else if constexpr (std::is_same_v<T, LayerPolygon>) {
+            return OfPoints(s.pts.data(), s.pts.size(), 1);
+        } else if constexpr (std::is_same_v<T, LayerPoint>) {
+            return OfPoints(&s.pt, 1, 0);
+        } else if constexpr (std::is_same_v<T, LayerFill>) {
+            return Empty;
+        } else if constexpr (std::is_same_v<T, LayerQuarterCircleFilling>) {
+            // Small circles are centered inside the radius and stick out by their own radius
+            return FromCenter(s.center, s.radius, s.radius, Filling::SMALL_CIRCLE_MAX_RADIUS + 1);
+        } else if constexpr (std::is_same_v<T, LayerRectangleBezierWaves>) {
+            POINT pts[2] = {s.p1, s.p2};
+            return OfPoints(pts, 2, 1);
+        } else if constexpr (std::is_same_v<T, LayerCircleQuarter>) {
+            return FromCenter(s.center, s.radius, s.radius, 1);
+        } else if constexpr (std::is_same_v<T, LayerSquareHermiteWaves>) {
+            POINT pts[2] = {s.topLeft, {s.topLeft.x + s.size, s.topLeft.y + s.size}};
+            return OfPoints(pts, 2, 1);
+        } else if constexpr (std::is_same_v<T, LayerBezierCurve>) {
+            // A flattened curve is drawn along the polyline itself; the forward differences plot the
+            // curve, which is within BEZIER_FLATNESS of the polyline, so a margin of 2 covers it
+            std::vector<double> control = {(double)s.p0.x, (double)s.p0.y, (double)s.p1.x, (double)s.p1.y,
+                                           (double)s.p2.x, (double)s.p2.y, (double)s.p3.x, (double)s.p3.y};
+            std::vector<POINT> polyline;
+            ThirdDegreeCurve::FlattenBezier(control, polyline);
+            return OfPoints(polyline.data(), polyline.size(), s.alg == BEZIER_FLATTENED ? 1 : 2);
+        } else if constexpr (std::is_same_v<T, LayerCardinalSpline>) {
+            // Each Hermite segment lies in the hull of p[i], p[i] + q[i]/3, p[i+1] - q[i+1]/3, p[i+1];
+            // the tangents q are at most half the distance between neighbours (C = 1), and an
+            // end point stands in for its missing neighbour
+            size_t n = s.points.size() / 2;
+            if (n == 0) return Empty;
+            std::vector<POINT> pts(n);
+            double maxTangent = 0;
+            for (size_t i = 0; i < n; ++i) {
+                pts[i] = POINT{(LONG)s.points[2 * i], (LONG)s.points[2 * i + 1]};
+                size_t prev = i > 0 ? i - 1 : i;
+                size_t next = i + 1 < n ? i + 1 : i;
+                maxTangent = std::max(maxTangent, std::fabs(s.points[2 * next] - s.points[2 * prev]) / 2.0);
+                maxTangent = std::max(maxTangent, std::fabs(s.points[2 * next + 1] - s.points[2 * prev + 1]) / 2.0);
+            }
+            return OfPoints(pts.data(), n, 1 + (int)std::ceil(maxTangent / 3.0));
+        }
+        return Empty;
+    }, shape);
+}
+
+// FramebufferSink over a canvas box, addressed in canvas coordinates
+class BoxSink {
+public:
+    BoxSink(const RECT& box, std::vector<uint32_t>& pixels)
+        : box(box), fb(pixels.data(), (int)(box.right - box.left), (int)(box.bottom - box.top)) {}
+
+    void setPixel(int x, int y, COLORREF c) { fb.setPixel(x - box.left, y - box.top, c); }
+    COLORREF getPixel(int x, int y) const { return fb.getPixel(x - box.left, y - box.top); }
+    void fillSpan(int y, int x0, int x1, COLORREF c) { fb.fillSpan(y - box.top, x0 - box.left, x1 - box.left, c); }
+    RECT bounds() const { return box; }
+
+private:
+    RECT box;
+    FramebufferSink fb;
+};
+
+// Box of a flood from the seed: the target's when the flood stays inside its outline, else Everything.
+// The floods stop only at pixels of the fill color, so the outline is drawn alone on a background of
+// any other color, in a box one pixel wider than the target's cut down to the canvas; other layers can
+// only stop the real flood sooner. A seed off the canvas, or a flood that runs into the canvas edge,
+// gets Everything. The answer is kept in the fill until InvalidateFillCaches drops it.
+static RECT FloodExtent(const std::vector<Layer>& layers, const LayerFill& fill, const RECT& target, const RECT& canvas) {
+    if (fill.extent) return *fill.extent;
+    RECT box = LayerBounds::Intersection(RECT{target.left - 1, target.top - 1, target.right + 1, target.bottom + 1}, canvas);
+    fill.extent = LayerBounds::Everything;
+    if (!LayerBounds::ContainsPoint(box, fill.fillPoint)) return *fill.extent;
+    std::vector<uint32_t> pixels((size_t)(box.right - box.left) * (box.bottom - box.top), FramebufferSink::ToPixel(fill.color ^ 1));
+    BoxSink sink(box, pixels);
+    LayerRenderer::RenderLayer(sink, layers, layers[fill.target]);
+    SpanRecorder<BoxSink> recorder(sink);
+    Filling::NonRecursiveFloodFill(recorder, fill.fillPoint.x, fill.fillPoint.y, fill.color);
+    if (!recorder.reachedEdge) fill.extent = target;
+    return *fill.extent;
+}
+
+RECT LayerBounds::Of(const std::vector<Layer>& layers, size_t index, const RECT& canvas) {
+    const LayerShape& shape = layers[index].shape;
+    if (const LayerFill* fill = std::get_if<LayerFill>(&shape)) {
+        // A recorded flood is exactly its spans
+        if (fill->spans) {
+            RECT box = Empty;
+            for (const SpanMask::Span& span : fill->spans->spans()) {
+                box = Union(box, RECT{span.x0, span.y, span.x1 + 1, span.y + 1});
+            }
+            return box;
+        }
+        if (fill->target < 0 || (size_t)fill->target >= layers.size()) return Empty;
+        RECT target = OfShape(layers[fill->target].shape);
+        // Scanline fills cover the target polygon whatever the seed; a flood is bounded by the
+        // target only when the seed lies inside its outline, not just inside its box
+        if (fill->alg != FILL_RECURSIVE_FLOOD && fill->alg != FILL_NONRECURSIVE_FLOOD) return target;
+        return FloodExtent(layers, *fill, target, canvas);
+    }
+    return OfShape(shape);
+}
+
+bool LayerBounds::IsEmpty(const RECT& r) {
+    return r.left >= r.right || r.top >= r.bottom;
+}
+
+bool LayerBounds::Intersects(const RECT& a, const RECT& b) {
+    return !IsEmpty(a) && !IsEmpty(b) &&
+           a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+bool LayerBounds::Contains(const RECT& outer, const RECT& inner) {
+    return IsEmpty(inner) ||
+           (inner.left >= outer.left && inner.right <= outer.right && inner.top >= outer.top && inner.bottom <= outer.bottom);
+}
+
+bool LayerBounds::ContainsPoint(const RECT& r, POINT p) {
+    return p.x >= r.left && p.x < r.right && p.y >= r.top && p.y < r.bottom;
+}
+
+RECT LayerBounds::Union(const RECT& a, const RECT& b) {
+    if (IsEmpty(a)) return b;
+    if (IsEmpty(b)) return a;
+    return RECT{std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right), std::max(a.bottom, b.bottom)};
+}
+
+RECT LayerBounds::Intersection(const RECT& a, const RECT& b) {
+    RECT r = {std::max(a.left, b.left), std::max(a.top, b.top), std::min(a.right, b.right), std::min(a.bottom, b.bottom)};
+    return IsEmpty(r) ? Empty : r;
+}
@@ -11,6 +11,8 @@
 #include "../include/clipping.h"
 #include "../include/storage.h"
 #include "../include/layer.h"
+#include "../include/layer_renderer.h"
+#include "../include/layer_bounds.h"
 #include <commdlg.h>
 #include <fstream>
 #include <sstream>
@@ -18,6 +20,7 @@
 #include <variant>
 #include <optional>
 #include <cmath>
+#include <cstdint>
 
 using namespace std;
 
@@ -88,6 +91,7 @@ static MenuShapeType currentShape = SHAPE_NONE;
 static LineAlgorithm currentLineAlg = LINE_DDA;
 static CircleAlgorithm currentCircleAlg = CIRCLE_DIRECT;
 static EllipseAlgorithm currentEllipseAlg = ELLIPSE_DIRECT;
+static BezierAlgorithm currentBezierAlg = BEZIER_FORWARD_DIFFERENCES;
 
 // Currently selected clipping window type (rectangle or square)
 static ClippingWindowType currentClipWindowType = CLIP_RECTANGLE;
@@ -122,6 +126,8 @@ static std::optional<POINT> clipWindowStart;
 static std::optional<POINT> clipWindowCurrent;
 static std::optional<LayerPolygon> originalPolygonLayer;
 static std::optional<LayerPolygon> lastPolygonClipped;
+// Cardinal spline being entered; its segments are flattened once as points are added
+static CardinalSpline cardinalSpline;
 // Extra: state for quarter circles filling
 static bool extraQuarterCircleActive = false;
 static int extraQuarterStage = 0; // 0: none, 1: center set, 2: radius set
@@ -145,6 +151,22 @@ static int extraSquareHermiteStage = 0; // 0: none, 1: top-left set
 static POINT extraSquareHermiteTopLeft = {0,0};
 static int extraSquareHermiteSize = 0;
 
+// ===== Backbuffer =====
+// Committed layers are composited once into a 32-bit DIB section and blitted on WM_PAINT.
+// Previews are drawn over the blit, so rubber-banding cost does not grow with the scene.
+// layers[0..backbufferLayerCount) are already in the backbuffer; appended layers are drawn
+// incrementally. Replacing or removing a layer marks its box dirty (MarkBackbufferDirty) and
+// only that region is recomposited; Clear/Load call InvalidateBackbuffer() instead.
+static HDC backbufferDC = NULL;
+static HBITMAP backbufferBitmap = NULL;
+static HGDIOBJ backbufferOldBitmap = NULL;
+static uint32_t* backbufferPixels = nullptr;
+static int backbufferWidth = 0;
+static int backbufferHeight = 0;
+static size_t backbufferLayerCount = 0;
+static bool backbufferValid = false;
+static RECT backbufferDirty = {0, 0, 0, 0};
+
 // ===== Utility Functions =====
 // log_debug: Writes debug messages to a file for troubleshooting
 // DrawPolygon: Draws a closed polygon using the midpoint line algorithm
@@ -155,12 +177,168 @@ void log_debug(const std::string& msg) {
 
 // Function to draw a polygon using line algorithms
 void DrawPolygon(HDC hdc, const std::vector<POINT>& points, COLORREF color) {
-    if (points.size() < 2) return;
+    GdiSink sink(hdc);
+    LayerRenderer::DrawPolygon(sink, points, color);
+}
+
+// ===== Backbuffer Management =====
+// ReleaseBackbuffer: Frees the DIB section and its memory DC
+// EnsureBackbuffer: (Re)creates the backbuffer when the client size changes
+// InvalidateBackbuffer: Forces a full recomposite (scene cleared or reloaded)
+// MarkBackbufferDirty: Recomposites only `box` on the next paint (layers inside it replaced or removed)
+// InvalidateBox: Asks Windows to repaint only `box` of the client area
+// RecompositeRegion: Clears a region of the backbuffer and redraws the layers that touch it
+// SyncBackbuffer: Draws the layers that are not yet composited into the backbuffer
+void ReleaseBackbuffer() {
+    if (backbufferDC) {
+        SelectObject(backbufferDC, backbufferOldBitmap);
+        DeleteDC(backbufferDC);
+        backbufferDC = NULL;
+    }
+    if (backbufferBitmap) {
+        DeleteObject(backbufferBitmap);
+        backbufferBitmap = NULL;
+    }
+    backbufferPixels = nullptr;
+    backbufferWidth = backbufferHeight = 0;
+    backbufferValid = false;
+}
+
+bool EnsureBackbuffer(HDC hdc, int width, int height) {
+    if (width <= 0 || height <= 0) return false;
+    if (backbufferDC && width == backbufferWidth && height == backbufferHeight) return true;
+
+    ReleaseBackbuffer();
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height; // top-down rows, matching FramebufferSink
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    void* bits = nullptr;
+    backbufferBitmap = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (!backbufferBitmap) return false;
+    backbufferDC = CreateCompatibleDC(hdc);
+    backbufferOldBitmap = SelectObject(backbufferDC, backbufferBitmap);
+    backbufferPixels = static_cast<uint32_t*>(bits);
+    backbufferWidth = width;
+    backbufferHeight = height;
+    backbufferValid = false;
+    return true;
+}
+
+void InvalidateBackbuffer() {
+    backbufferValid = false;
+    backbufferDirty = LayerBounds::Empty;
+}
+
+void MarkBackbufferDirty(const RECT& box) {
+    backbufferDirty = LayerBounds::Union(backbufferDirty, box);
+}
+
+void InvalidateBox(HWND hWnd, const RECT& box) {
+    if (!LayerBounds::IsEmpty(box)) InvalidateRect(hWnd, &box, FALSE);
+}
+
+void RecompositeRegion(RECT region) {
+    RECT canvas = {0, 0, backbufferWidth, backbufferHeight};
+    region = LayerBounds::Intersection(region, canvas);
+    // Fills are replayed whole, so grow the region until it contains every fill it touches
+    bool grown = true;
+    while (grown && !LayerBounds::IsEmpty(region)) {
+        grown = false;
+        for (size_t i = 0; i < backbufferLayerCount; ++i) {
+            if (!std::holds_alternative<LayerFill>(layers[i].shape)) continue;
+            RECT box = LayerBounds::Intersection(LayerBounds::Of(layers, i, canvas), canvas);
+            if (LayerBounds::Intersects(box, region) && !LayerBounds::Contains(region, box)) {
+                region = LayerBounds::Union(region, box);
+                grown = true;
+            }
+        }
+    }
+    if (LayerBounds::IsEmpty(region)) return;
+
+    uint32_t white = FramebufferSink::ToPixel(RGB(255, 255, 255));
+    for (LONG y = region.top; y < region.bottom; ++y) {
+        uint32_t* row = backbufferPixels + (size_t)y * backbufferWidth;
+        std::fill(row + region.left, row + region.right, white);
+    }
+    FramebufferSink sink(backbufferPixels, backbufferWidth, backbufferHeight);
+    sink.setClip(region.left, region.top, region.right, region.bottom);
+    LayerRenderer::RenderLayersInRect(sink, layers, backbufferLayerCount, region);
+}
+
+void SyncBackbuffer() {
+    FramebufferSink sink(backbufferPixels, backbufferWidth, backbufferHeight);
+    bool dirty = !LayerBounds::IsEmpty(backbufferDirty);
+    GdiFlush(); // GDI must be done with the DIB before we write to its bits
+    if (!backbufferValid || (backbufferLayerCount > layers.size() && !dirty)) {
+        std::fill(backbufferPixels, backbufferPixels + (size_t)backbufferWidth * backbufferHeight,
+                  FramebufferSink::ToPixel(RGB(255, 255, 255)));
+        backbufferLayerCount = 0;
+        backbufferValid = true;
+        backbufferDirty = LayerBounds::Empty;
+        dirty = false;
+    }
+    if (dirty) {
+        // Removed layers lie inside the dirty region, which is redrawn from the surviving ones
+        backbufferLayerCount = min(backbufferLayerCount, layers.size());
+        RecompositeRegion(backbufferDirty);
+        backbufferDirty = LayerBounds::Empty;
+    }
+    for (size_t i = backbufferLayerCount; i < layers.size(); ++i) {
+        LayerRenderer::RenderLayer(sink, layers, layers[i]);
+    }
+    backbufferLayerCount = layers.size();
+}
+
+// ===== Damage Boxes =====
+// CanvasBox: The client area the layers are drawn into
+// InvalidateLastLayer: Repaints the box of a freshly appended layer
+// LinePreviewBox / ClipPreviewBox: Screen area covered by the rubber-band previews
+// CardinalPreviewBox: Screen area changed by the last point added to the cardinal spline
+RECT CanvasBox(HWND hWnd) {
+    RECT client;
+    GetClientRect(hWnd, &client);
+    return client;
+}
+
+void InvalidateLastLayer(HWND hWnd) {
+    InvalidateBox(hWnd, LayerBounds::Of(layers, layers.size() - 1, CanvasBox(hWnd)));
+}
+
+RECT LinePreviewBox() {
+    if (!linePreviewStart || !linePreviewCurrent) return LayerBounds::Empty;
+    POINT pts[2] = {*linePreviewStart, *linePreviewCurrent};
+    return LayerBounds::OfPoints(pts, 2);
+}
+
+RECT ClipPreviewBox() {
+    if (!clipWindowStart || !clipWindowCurrent) return LayerBounds::Empty;
+    POINT pts[2] = {*clipWindowStart, *clipWindowCurrent};
+    if (currentClipWindowType == CLIP_SQUARE) {
+        int side = max(abs(pts[1].x - pts[0].x), abs(pts[1].y - pts[0].y));
+        pts[1].x = pts[0].x + (pts[1].x >= pts[0].x ? side : -side);
+        pts[1].y = pts[0].y + (pts[1].y >= pts[0].y ? side : -side);
+    }
+    return LayerBounds::OfPoints(pts, 2);
+}
 
-    // Draw lines between consecutive points using midpoint algorithm
-    for (size_t i = 0; i < points.size() - 1; i++) {
-        Lines::DrawLineByMidPoint(hdc, points[i].x, points[i].y, points[i + 1].x, points[i + 1].y, color);
+RECT CardinalPreviewBox() {
+    size_t n = cardinalSpline.pointCount();
+    if (n == 0) return LayerBounds::Empty;
+    // The marker of the new point (Ellipse is right/bottom exclusive)
+    const std::vector<double>& p = cardinalSpline.points();
+    POINT last = {(LONG)p[2 * n - 2], (LONG)p[2 * n - 1]};
+    RECT box = LayerBounds::OfPoints(&last, 1, 3);
+    // The curve appears at the fourth point; later points only change the last two segments
+    if (n < 4) return box;
+    size_t first = n == 4 ? 0 : cardinalSpline.segmentCount() - 2;
+    for (size_t i = first; i < cardinalSpline.segmentCount(); i++) {
+        box = LayerBounds::Union(box, cardinalSpline.segmentBounds(i));
     }
+    return box;
 }
 
 // ===== Window Procedure =====
@@ -171,7 +349,6 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     static int x1, y1, x2, y2;
     static vector<double> points;
     static int counter = 0;
-    static std::vector<double> cardinalSplinePoints; // Stores input points for Cardinal Spline
 
     switch (message)
     {
@@ -227,6 +404,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         AppendMenu(hEllipseMenu, MF_STRING, 5003, "Midpoint");
         AppendMenu(hMenuBar, MF_POPUP, (UINT_PTR)hEllipseMenu, "Ellipse Algorithm");
 
+        HMENU hBezierMenu = CreatePopupMenu();
+        AppendMenu(hBezierMenu, MF_STRING, 11001, "Forward Differences");
+        AppendMenu(hBezierMenu, MF_STRING, 11002, "Adaptive Flattening");
+        AppendMenu(hMenuBar, MF_POPUP, (UINT_PTR)hBezierMenu, "Bezier Algorithm");
+
 
         // Clipping window type menu
         HMENU hClipTypeMenu = CreatePopupMenu();
@@ -303,6 +485,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 // If the user selects a file, load the layers from that file
                 if (GetOpenFileName(&ofn)) {
                     if (Storage::loadLayersFromFile(layers, szFile)) {
+                        InvalidateBackbuffer();
                         InvalidateRect(hWnd, NULL, TRUE);
                         MessageBox(hWnd, "Layers loaded successfully!", "Load", MB_OK | MB_ICONINFORMATION);
                     } else {
@@ -315,6 +498,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             else if (id == 1003) {
                 // Clear all layers and reset state
                 layers.clear();
+                InvalidateBackbuffer();
                 userPoints.clear();
                 currentPolygon.reset();
                 InvalidateRect(hWnd, NULL, TRUE);
@@ -367,7 +551,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             else if (id == 2010) { // Cardinal Spline menu item
                 currentShape = SHAPE_CARDINAL_SPLINE;
                 userPoints.clear();
-                cardinalSplinePoints.clear();
+                cardinalSpline.clear();
                 InvalidateRect(hWnd, NULL, TRUE);
             }
             // Help menu handler
@@ -379,6 +563,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                     "- For polygons: Left-click to add points, right-click to finish.\n"
                     "- For circles/ellipses/rectangles: Left-click two points.\n"
                     "- For Bezier Spline: Select 'Spline', then left-click 4 control points.\n"
+                    "  Use the 'Bezier Algorithm' menu to choose forward differences or adaptive flattening.\n"
                     "- For Cardinal Spline: Select 'Cardinal Spline', left-click to add as many points as you want (minimum 4), right-click to draw the spline.\n"
                     "  If you right-click with fewer than 4 points, an error will be shown.\n"
                     "  Small preview circles will appear at each point as you click.\n"
@@ -399,6 +584,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             else if (id >= 3001 && id <= 3003) { currentLineAlg = (LineAlgorithm)(id - 3001); }
             else if (id >= 4001 && id <= 4005) { currentCircleAlg = (CircleAlgorithm)(id - 4001); }
             else if (id >= 5001 && id <= 5003) { currentEllipseAlg = (EllipseAlgorithm)(id - 5001); }
+            else if (id >= 11001 && id <= 11002) { currentBezierAlg = (BezierAlgorithm)(id - 11001); }
             // Color menu handler
             else if (id == 6001) {
                 CHOOSECOLOR cc = { sizeof(CHOOSECOLOR) };
@@ -495,7 +681,10 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 Clipping::SetClipWindow(xmin, ymin, xmax, ymax);
 
                 // Only process the last layer if it exists
+                RECT damaged = ClipPreviewBox();
                 if (!layers.empty()) {
+                    size_t lastIndex = layers.size() - 1;
+                    RECT before = LayerBounds::Of(layers, lastIndex, CanvasBox(hWnd));
                     Layer& lastLayer = layers.back();
                     std::visit([&](auto&& shape) {
                         using T = std::decay_t<decltype(shape)>;
@@ -562,13 +751,18 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                             }
                         }
                     }, lastLayer.shape);
+                    // Last layer was replaced or removed: only its old and new boxes change
+                    RECT after = layers.size() > lastIndex ? LayerBounds::Of(layers, lastIndex, CanvasBox(hWnd)) : LayerBounds::Empty;
+                    MarkBackbufferDirty(LayerBounds::Union(before, after));
+                    LayerRenderer::InvalidateFillCaches(layers, lastIndex);
+                    damaged = LayerBounds::Union(damaged, LayerBounds::Union(before, after));
                 }
 
                 // Reset state
                 userPoints.clear();
                 clipWindowStart.reset();
                 clipWindowCurrent.reset();
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateBox(hWnd, damaged);
             }
         }
         // Handle polygon point addition
@@ -584,11 +778,13 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             
             if (Common::isValidPolygon(testPoints)) {
                 currentPolygon->pts.push_back(newPoint);
+                // Only the new preview edge needs to be drawn
+                size_t n = currentPolygon->pts.size();
+                InvalidateBox(hWnd, LayerBounds::OfPoints(&currentPolygon->pts[n - min(n, (size_t)2)], min(n, (size_t)2)));
             } else {
                 MessageBox(hWnd, "This point is too close to existing points. Please choose a different point.", 
                           "Invalid Point", MB_OK | MB_ICONWARNING);
             }
-            InvalidateRect(hWnd, NULL, TRUE);
         }
         // Handle line drawing
         else if (currentShape == SHAPE_LINE) {
@@ -596,10 +792,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 linePreviewStart = POINT{x, y};
                 linePreviewCurrent = POINT{x, y};
             } else {
+                RECT preview = LinePreviewBox();
                 layers.push_back(Layer{LayerLine{*linePreviewStart, POINT{x, y}, currentColor, currentLineAlg}});
                 linePreviewStart.reset();
                 linePreviewCurrent.reset();
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateBox(hWnd, LayerBounds::Union(preview, LayerBounds::Of(layers, layers.size() - 1, CanvasBox(hWnd))));
             }
         }
         // Handle circle drawing
@@ -609,7 +806,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 int r = (int)hypot(userPoints[1].x - userPoints[0].x, userPoints[1].y - userPoints[0].y);
                 layers.push_back(Layer{LayerCircle{userPoints[0], r, currentColor, currentCircleAlg}});
                 userPoints.clear();
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateLastLayer(hWnd);
             }
         }
         // Handle ellipse drawing
@@ -620,7 +817,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 int b = abs(userPoints[1].y - userPoints[0].y);
                 layers.push_back(Layer{LayerEllipse{userPoints[0], a, b, currentColor, currentEllipseAlg}});
                 userPoints.clear();
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateLastLayer(hWnd);
             }
         }
         // Handle rectangle drawing
@@ -629,25 +826,27 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             if (userPoints.size() == 2) {
                 layers.push_back(Layer{LayerRect{userPoints[0], userPoints[1], currentColor}});
                 userPoints.clear();
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateLastLayer(hWnd);
             }
         }
         // Handle spline/curve drawing
         else if (currentShape == SHAPE_SPLINE) {
             userPoints.push_back(POINT{x, y});
             if (userPoints.size() == 4) {
-                layers.push_back(Layer{LayerBezierCurve{userPoints[0], userPoints[1], userPoints[2], userPoints[3], currentColor}});
+                layers.push_back(Layer{LayerBezierCurve{userPoints[0], userPoints[1], userPoints[2], userPoints[3], currentColor, currentBezierAlg}});
                 userPoints.clear();
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateLastLayer(hWnd);
             } else {
                 InvalidateRect(hWnd, NULL, FALSE);
             }
         }
         // Handle Cardinal Spline point input
         else if (currentShape == SHAPE_CARDINAL_SPLINE) {
-            cardinalSplinePoints.push_back(x);
-            cardinalSplinePoints.push_back(y);
-            InvalidateRect(hWnd, NULL, FALSE);
+            // The old last segment is re-flattened, so the pixels it covered are repainted too
+            size_t segments = cardinalSpline.segmentCount();
+            RECT before = segments > 0 ? cardinalSpline.segmentBounds(segments - 1) : LayerBounds::Empty;
+            cardinalSpline.append(x, y);
+            InvalidateBox(hWnd, LayerBounds::Union(before, CardinalPreviewBox()));
         }
         // Handle filling
         else if (currentShape == SHAPE_FILL) {
@@ -659,14 +858,14 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                                 std::is_same_v<T, LayerRect> ||
                                 std::is_same_v<T, LayerCircle> ||
                                 std::is_same_v<T, LayerEllipse>) {
-                        layers.push_back(Layer{LayerFill{{x, y}, shape.color, currentFillAlg}});
+                        layers.push_back(Layer{LayerFill{{x, y}, shape.color, currentFillAlg, (int)layers.size() - 1, nullptr, std::nullopt}});
+                        InvalidateLastLayer(hWnd);
                     } else {
                         MessageBox(hWnd, "This shape does not support filling.", 
                                   "Invalid Shape", MB_OK | MB_ICONWARNING);
                     }
                 }, lastLayer.shape);
             }
-            InvalidateRect(hWnd, NULL, TRUE);
         }
         // Handle dynamic quarter circle filling
         else if (currentShape == SHAPE_EXTRA_QUARTER_CIRCLES && extraQuarterCircleActive) {
@@ -699,7 +898,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 layers.push_back(Layer{LayerQuarterCircleFilling{extraQuarterCenter, extraQuarterRadius, extraQuarterQuarter, currentColor}});
                 extraQuarterCircleActive = false;
                 extraQuarterStage = 0;
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateLastLayer(hWnd); // the preview circle lies inside the layer box
             }
         }
         // Handle dynamic rectangle Bezier waves
@@ -746,7 +945,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 layers.push_back(Layer{LayerCircleQuarter{extraCircleQuarterCenter, extraCircleQuarterRadius, extraCircleQuarterQuarter, currentColor}});
                 extraCircleQuarterActive = false;
                 extraCircleQuarterStage = 0;
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateLastLayer(hWnd); // the preview circle lies inside the layer box
             }
         }
         // Extra: Square Hermite Waves (2 clicks: top-left, size)
@@ -775,12 +974,15 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             int x = LOWORD(lParam);
             int y = HIWORD(lParam);
             // Update preview positions for line and clip window
+            // Only the union of the old and new preview boxes has to be repainted
             if (currentShape == SHAPE_LINE && linePreviewStart) {
+                RECT before = LinePreviewBox();
                 linePreviewCurrent = POINT{x, y};
-                InvalidateRect(hWnd, NULL, FALSE);
+                InvalidateBox(hWnd, LayerBounds::Union(before, LinePreviewBox()));
             } else if (currentShape == SHAPE_CLIP && clipWindowStart) {
+                RECT before = ClipPreviewBox();
                 clipWindowCurrent = POINT{x, y};
-                InvalidateRect(hWnd, NULL, FALSE);
+                InvalidateBox(hWnd, LayerBounds::Union(before, ClipPreviewBox()));
             }
         }
         break;
@@ -797,30 +999,32 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 layers.push_back(Layer{LayerPolygon{*currentPolygon}});
                 originalPolygonLayer = *currentPolygon;
                 currentPolygon.reset();
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateLastLayer(hWnd);
             }
             // Cancel line preview
             else if (currentShape == SHAPE_LINE && linePreviewStart) {
+                RECT preview = LinePreviewBox();
                 linePreviewStart.reset();
                 linePreviewCurrent.reset();
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateBox(hWnd, preview);
             }
             // Cancel clipping window preview
             else if (currentShape == SHAPE_CLIP && clipWindowStart) {
+                RECT preview = ClipPreviewBox();
                 clipWindowStart.reset();
                 clipWindowCurrent.reset();
                 userPoints.clear();
-                InvalidateRect(hWnd, NULL, TRUE);
+                InvalidateBox(hWnd, preview);
             }
             // Finish Cardinal Spline input
             else if (currentShape == SHAPE_CARDINAL_SPLINE) {
                 // Only allow drawing if at least 4 points (8 values)
-                if (cardinalSplinePoints.size() < 8) {
+                if (cardinalSpline.pointCount() < 4) {
                     MessageBox(hWnd, "Cardinal Spline requires at least 4 points (8 clicks).", "Not enough points", MB_OK | MB_ICONERROR);
                 } else {
                     // Store the spline as a persistent layer
-                    layers.push_back(Layer{LayerCardinalSpline{cardinalSplinePoints, currentColor}});
-                    cardinalSplinePoints.clear();
+                    layers.push_back(Layer{LayerCardinalSpline{cardinalSpline.points(), currentColor}});
+                    cardinalSpline.clear();
                     InvalidateRect(hWnd, NULL, TRUE);
                 }
             }
@@ -831,148 +1035,19 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hWnd, &ps);
 
-            // Draw all layers
-            for (const auto& layer : layers) {
-                std::visit([&](auto&& shape) {
-                    using T = std::decay_t<decltype(shape)>;
-                    if constexpr (std::is_same_v<T, LayerLine>) {
-                        if (shape.alg == LINE_DDA)
-                            Lines::LineBresenhamDDA(hdc, shape.p1.x, shape.p1.y, shape.p2.x, shape.p2.y, shape.color);
-                        else if (shape.alg == LINE_MIDPOINT)
-                            Lines::DrawLineByMidPoint(hdc, shape.p1.x, shape.p1.y, shape.p2.x, shape.p2.y, shape.color);
-                    } else if constexpr (std::is_same_v<T, LayerCircle>) {
-                        if (shape.alg == CIRCLE_DIRECT)
-                            SecondDegreeCurve::directcircle(hdc, shape.center.x, shape.center.y, shape.r, shape.color);
-                        else if (shape.alg == CIRCLE_POLAR)
-                            SecondDegreeCurve::DrawCircle(hdc, shape.center.x, shape.center.y, shape.center.x + shape.r, shape.center.y, shape.color);
-                        else if (shape.alg == CIRCLE_ITERATIVE_POLAR)
-                            SecondDegreeCurve::itreativepolar(hdc, shape.center.x, shape.center.y, shape.r, shape.color);
-                        else if (shape.alg == CIRCLE_MIDPOINT)
-                            SecondDegreeCurve::BresenhamCircle(hdc, shape.center.x, shape.center.y, shape.r, shape.color);
-                        else if (shape.alg == CIRCLE_MODIFIED_MIDPOINT)
-                            SecondDegreeCurve::ModfiedBresenhamcircle(hdc, shape.center.x, shape.center.y, shape.r, shape.color);
-                    } else if constexpr (std::is_same_v<T, LayerEllipse>) {
-                        if (shape.alg == ELLIPSE_DIRECT)
-                            Ellipse::DrawEllipseEquation(hdc, shape.center.x, shape.center.y, shape.a, shape.b, shape.color);
-                        else if (shape.alg == ELLIPSE_POLAR)
-                            Ellipse::DrawEllipsePolar(hdc, shape.center.x, shape.center.y, shape.a, shape.b, shape.color);
-                        else if (shape.alg == ELLIPSE_MIDPOINT)
-                            Ellipse::DrawEllipseMidPoint(hdc, shape.center.x, shape.center.y, shape.a, shape.b, shape.color);
-                    } else if constexpr (std::is_same_v<T, LayerRect>) {
-                        POINT rectPoints[5] = {
-                            shape.p1,
-                            {shape.p2.x, shape.p1.y},
-                            shape.p2,
-                            {shape.p1.x, shape.p2.y},
-                            shape.p1
-                        };
-                        DrawPolygon(hdc, std::vector<POINT>(rectPoints, rectPoints + 5), shape.color);
-                    } else if constexpr (std::is_same_v<T, LayerPolygon>) {
-                        if (shape.pts.size() >= 2) {
-                            DrawPolygon(hdc, shape.pts, shape.color);
-                        }
-                    } else if constexpr (std::is_same_v<T, LayerPoint>) {
-                        SetPixel(hdc, shape.pt.x, shape.pt.y, shape.color);
-                    } else if constexpr (std::is_same_v<T, LayerFill>) {
-                        // Find the previous layer to fill
-                        for (auto it = layers.begin(); it != layers.end(); ++it) {
-                            if (&(*it) == &layer) {
-                                if (it != layers.begin()) {
-                                    --it;  // Move to the previous layer
-                                    std::visit([&](auto&& prevShape) {
-                                        using P = std::decay_t<decltype(prevShape)>;
-                                        if constexpr (std::is_same_v<P, LayerPolygon>) {
-                                            if (prevShape.pts.size() >= 3) {
-                                                switch (shape.alg) {
-                                                    case FILL_RECURSIVE_FLOOD:
-                                                        Filling::RecursiveFloodFill(hdc, shape.fillPoint.x, shape.fillPoint.y, shape.color);
-                                                        break;
-                                                    case FILL_NONRECURSIVE_FLOOD:
-                                                        Filling::NonRecursiveFloodFill(hdc, shape.fillPoint.x, shape.fillPoint.y, shape.color);
-                                                        break;
-                                                    case FILL_CONVEX:
-                                                        if (Common::IsConvex(prevShape.pts)) {
-                                                            Filling::ConvexFill(hdc, prevShape.pts, shape.color);
-                                                        }
-                                                        break;
-                                                    case FILL_NONCONVEX:
-                                                        Filling::NonConvexFill(hdc, prevShape.pts, shape.color);
-                                                        break;
-                                                }
-                                            }
-                                        } else if constexpr (std::is_same_v<P, LayerRect>) {
-                                            std::vector<POINT> rectPoints = {
-                                                prevShape.p1,
-                                                {prevShape.p2.x, prevShape.p1.y},
-                                                prevShape.p2,
-                                                {prevShape.p1.x, prevShape.p2.y},
-                                                prevShape.p1
-                                            };
-                                            switch (shape.alg) {
-                                                case FILL_RECURSIVE_FLOOD:
-                                                    Filling::RecursiveFloodFill(hdc, shape.fillPoint.x, shape.fillPoint.y, shape.color);
-                                                    break;
-                                                case FILL_NONRECURSIVE_FLOOD:
-                                                    Filling::NonRecursiveFloodFill(hdc, shape.fillPoint.x, shape.fillPoint.y, shape.color);
-                                                    break;
-                                                case FILL_CONVEX:
-                                                    Filling::ConvexFill(hdc, rectPoints, shape.color);
-                                                    break;
-                                                case FILL_NONCONVEX:
-                                                    Filling::NonConvexFill(hdc, rectPoints, shape.color);
-                                                    break;
-                                            }
-                                        } else if constexpr (std::is_same_v<P, LayerCircle> || std::is_same_v<P, LayerEllipse>) {
-                                            if (shape.alg == FILL_RECURSIVE_FLOOD) {
-                                                Filling::RecursiveFloodFill(hdc, shape.fillPoint.x, shape.fillPoint.y, shape.color);
-                                            } else if (shape.alg == FILL_NONRECURSIVE_FLOOD) {
-                                                Filling::NonRecursiveFloodFill(hdc, shape.fillPoint.x, shape.fillPoint.y, shape.color);
-                                            }
-                                        }
-                                    }, it->shape);
-                                }
-                                break;
-                            }
-                        }
-                    } else if constexpr (std::is_same_v<T, LayerQuarterCircleFilling>) {
-                        // Draw the circle boundary
-                        SecondDegreeCurve::BresenhamCircle(hdc, shape.center.x, shape.center.y, shape.radius, shape.color);
-                        // Draw the filled quarter
-                        Filling::FillQuarterWithSmallCircles(hdc, shape.center.x, shape.center.y, shape.radius, shape.quarter, shape.color);
-                    } else if constexpr (std::is_same_v<T, LayerRectangleBezierWaves>) {
-                        // Draw rectangle boundary
-                        POINT rectPoints[5] = {
-                            shape.p1,
-                            {shape.p2.x, shape.p1.y},
-                            shape.p2,
-                            {shape.p1.x, shape.p2.y},
-                            shape.p1
-                        };
-                        DrawPolygon(hdc, std::vector<POINT>(rectPoints, rectPoints + 5), shape.color);
-                        // Fill with Bezier waves
-                        Filling::FillRectangleWithBezierWaves(hdc, shape.p1.x, shape.p1.y, shape.p2.x, shape.p2.y, shape.color);
-                    } else if constexpr (std::is_same_v<T, LayerCircleQuarter>) {
-                        SecondDegreeCurve::BresenhamCircle(hdc, shape.center.x, shape.center.y, shape.radius, shape.color);
-                        Filling::FillCircleQuarter(hdc, shape.center.x, shape.center.y, shape.radius, shape.quarter, shape.color);
-                    } else if constexpr (std::is_same_v<T, LayerSquareHermiteWaves>) {
-                        // Draw square boundary
-                        POINT pts[5] = {
-                            shape.topLeft,
-                            {shape.topLeft.x + shape.size, shape.topLeft.y},
-                            {shape.topLeft.x + shape.size, shape.topLeft.y + shape.size},
-                            {shape.topLeft.x, shape.topLeft.y + shape.size},
-                            shape.topLeft
-                        };
-                        DrawPolygon(hdc, std::vector<POINT>(pts, pts + 5), shape.color);
-                        Filling::FillSquareWithVerticalHermiteWaves(hdc, shape.topLeft.x, shape.topLeft.y, shape.size, shape.color);
-                    } else if constexpr (std::is_same_v<T, LayerBezierCurve>) {
-                        ThirdDegreeCurve::BezierCurve(hdc, shape.p0.x, shape.p0.y, shape.p1.x, shape.p1.y, shape.p2.x, shape.p2.y, shape.p3.x, shape.p3.y, shape.color);
-                    } else if constexpr (std::is_same_v<T, LayerCardinalSpline>) {
-                        if (shape.points.size() >= 8) {
-                            ThirdDegreeCurve::CardinalSplines(hdc, shape.points, 1, shape.color);
-                        }
-                    }
-                }, layer.shape);
+            // Composite committed layers into the backbuffer (only new ones, unless invalidated)
+            // and blit the damaged area; fall back to drawing directly if it can't be allocated
+            RECT client;
+            GetClientRect(hWnd, &client);
+            if (EnsureBackbuffer(hdc, client.right - client.left, client.bottom - client.top)) {
+                SyncBackbuffer();
+                BitBlt(hdc, ps.rcPaint.left, ps.rcPaint.top,
+                       ps.rcPaint.right - ps.rcPaint.left, ps.rcPaint.bottom - ps.rcPaint.top,
+                       backbufferDC, ps.rcPaint.left, ps.rcPaint.top, SRCCOPY);
+            } else {
+                FillRect(hdc, &ps.rcPaint, (HBRUSH)GetStockObject(WHITE_BRUSH));
+                GdiSink sink(hdc);
+                LayerRenderer::RenderLayersInRect(sink, layers, layers.size(), ps.rcPaint);
             }
 
             // Draw previews
@@ -1036,16 +1111,17 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 DeleteObject(hPen);
             }
             // Draw preview for Cardinal Spline
-            if (currentShape == SHAPE_CARDINAL_SPLINE && cardinalSplinePoints.size() >= 2) {
+            if (currentShape == SHAPE_CARDINAL_SPLINE && cardinalSpline.pointCount() >= 1) {
                 // Draw small preview circles at each input point
-                for (size_t i = 0; i + 1 < cardinalSplinePoints.size(); i += 2) {
-                    int px = (int)cardinalSplinePoints[i];
-                    int py = (int)cardinalSplinePoints[i + 1];
+                const std::vector<double>& splinePoints = cardinalSpline.points();
+                for (size_t i = 0; i + 1 < splinePoints.size(); i += 2) {
+                    int px = (int)splinePoints[i];
+                    int py = (int)splinePoints[i + 1];
                     Ellipse(hdc, px - 3, py - 3, px + 3, py + 3);
                 }
-                // Only preview spline if at least 4 points
-                if (cardinalSplinePoints.size() >= 8) {
-                    ThirdDegreeCurve::CardinalSplines(hdc, cardinalSplinePoints, 1, currentColor);
+                // Only preview spline if at least 4 points; cached segments outside the update region are skipped
+                if (cardinalSpline.pointCount() >= 4) {
+                    cardinalSpline.Draw(hdc, currentColor, ps.rcPaint);
                 }
             }
 
@@ -1053,11 +1129,16 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         }
         break;
 
+    case WM_ERASEBKGND:
+        // The backbuffer blit covers the whole client area; skipping the erase avoids flicker
+        return 1;
+
     case WM_CLOSE:
         DestroyWindow(hWnd);
         break;
 
     case WM_DESTROY:
+        ReleaseBackbuffer();
         PostQuitMessage(0);
         break;
 
@@ -0,0 +1,24 @@
+#include "../include/span_mask.h"
+#include <algorithm>
+
+SpanMask SpanMask::FromPixels(std::vector<POINT>& pixels) {
+    std::sort(pixels.begin(), pixels.end(), [](const POINT& a, const POINT& b) {
+        return a.y != b.y ? a.y < b.y : a.x < b.x;
+    });
+    SpanMask mask;
+    for (const POINT& p : pixels) {
+        Span* last = mask.runs.empty() ? nullptr : &mask.runs.back();
+        if (last && last->y == p.y && p.x <= last->x1 + 1) {
+            last->x1 = std::max(last->x1, (int)p.x);
+        } else {
+            mask.runs.push_back(Span{(int)p.y, (int)p.x, (int)p.x});
+        }
+    }
+    return mask;
+}
+
+size_t SpanMask::pixelCount() const {
+    size_t n = 0;
+    for (const Span& s : runs) n += (size_t)(s.x1 - s.x0 + 1);
+    return n;
+}
@@ -2,6 +2,7 @@
 #include "../include/import.h"
 #include "../include/common.h"
 #include "../include/layer.h"
+#include "../include/pixel_sink.h"
 #include <fstream>
 #include <sstream>
 #include <utility> // for std::pair
@@ -31,6 +32,8 @@ bool Storage::saveToFile(const std::string& path)
 // Overload for backward compatibility (default file name)
 bool Storage::saveToFile() { return saveToFile("drawing.txt"); }
 
+// Canvas functions draw through GDI and are only available in the Windows build
+#ifdef _WIN32
 // Clear the canvas and remove all drawings
 void Storage::clearCanvas(HWND hwnd)
 {
@@ -79,6 +82,7 @@ bool Storage::loadFromFile(HDC hdc, const std::string& path)
 }
 // Overload for backward compatibility (default file name)
 bool Storage::loadFromFile(HDC hdc) { return loadFromFile(hdc, "drawing.txt"); }
+#endif
 
    
 
@@ -128,7 +132,7 @@ bool Storage::saveLayersToFile(const std::vector<Layer>& layers, const std::stri
             } else if constexpr (std::is_same_v<T, LayerSquareHermiteWaves>) {
                 outFile << "square_hermite " << shape.topLeft.x << " " << shape.topLeft.y << " " << shape.size << " " << shape.color << "\n";
             } else if constexpr (std::is_same_v<T, LayerBezierCurve>) {
-                outFile << "bezier " << shape.p0.x << " " << shape.p0.y << " " << shape.p1.x << " " << shape.p1.y << " " << shape.p2.x << " " << shape.p2.y << " " << shape.p3.x << " " << shape.p3.y << " " << shape.color << "\n";
+                outFile << "bezier " << shape.p0.x << " " << shape.p0.y << " " << shape.p1.x << " " << shape.p1.y << " " << shape.p2.x << " " << shape.p2.y << " " << shape.p3.x << " " << shape.p3.y << " " << shape.color << " " << shape.alg << "\n";
             } else if constexpr (std::is_same_v<T, LayerCardinalSpline>) {
                 outFile << "cardinal_spline " << shape.points.size();
                 for (const auto& v : shape.points) outFile << " " << v;
@@ -184,7 +188,8 @@ bool Storage::loadLayersFromFile(std::vector<Layer>& layers, const std::string&
         } else if (type == "fill") {
             int x, y; COLORREF color; int alg;
             iss >> x >> y >> color >> alg;
-            layers.push_back(Layer{LayerFill{POINT{x, y}, color, (FillAlgorithm)alg}});
+            // A fill always targets the shape drawn right before it
+            layers.push_back(Layer{LayerFill{POINT{x, y}, color, (FillAlgorithm)alg, (int)layers.size() - 1, nullptr, std::nullopt}});
         } else if (type == "quarter_circle") {
             int cx, cy, radius, quarter; COLORREF color;
             iss >> cx >> cy >> radius >> quarter >> color;
@@ -202,9 +207,11 @@ bool Storage::loadLayersFromFile(std::vector<Layer>& layers, const std::string&
             iss >> x >> y >> size >> color;
             layers.push_back(Layer{LayerSquareHermiteWaves{POINT{x, y}, size, color}});
         } else if (type == "bezier") {
-            int x0, y0, x1, y1, x2, y2, x3, y3; COLORREF color;
+            int x0, y0, x1, y1, x2, y2, x3, y3; COLORREF color; int alg;
             iss >> x0 >> y0 >> x1 >> y1 >> x2 >> y2 >> x3 >> y3 >> color;
-            layers.push_back(Layer{LayerBezierCurve{POINT{x0, y0}, POINT{x1, y1}, POINT{x2, y2}, POINT{x3, y3}, color}});
+            // Files saved before the algorithm was recorded use forward differences
+            if (!(iss >> alg)) alg = BEZIER_FORWARD_DIFFERENCES;
+            layers.push_back(Layer{LayerBezierCurve{POINT{x0, y0}, POINT{x1, y1}, POINT{x2, y2}, POINT{x3, y3}, color, (BezierAlgorithm)alg}});
         } else if (type == "cardinal_spline") {
             size_t n; iss >> n;
             std::vector<double> points(n);
@@ -216,3 +223,52 @@ bool Storage::loadLayersFromFile(std::vector<Layer>& layers, const std::string&
     inFile.close();
     return true;
 }
+
+// Write a framebuffer as binary PPM (P6, 8-bit RGB)
+bool Storage::writePPM(std::ostream& out, const FramebufferSink& fb) {
+    out << "P6\n" << fb.width() << " " << fb.height() << "\n255\n";
+    std::vector<unsigned char> row((size_t)fb.width() * 3);
+    for (int y = 0; y < fb.height(); ++y) {
+        const uint32_t* src = fb.data() + (size_t)y * fb.stride();
+        for (int x = 0; x < fb.width(); ++x) {
+            row[3 * x + 0] = (unsigned char)(src[x] >> 16);
+            row[3 * x + 1] = (unsigned char)(src[x] >> 8);
+            row[3 * x + 2] = (unsigned char)(src[x]);
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+    return (bool)out;
+}
+
+// Write a framebuffer as an uncompressed 32-bit top-down BMP
+// Framebuffer pixels are already in BMP (0x00RRGGBB little-endian) order, so rows are copied as-is
+bool Storage::writeBMP(std::ostream& out, const FramebufferSink& fb) {
+    const uint32_t headerSize = 14 + 40;
+    const uint32_t imageSize = (uint32_t)fb.width() * fb.height() * 4;
+    auto put16 = [&out](uint16_t v) { out.put((char)(v & 0xFF)); out.put((char)(v >> 8)); };
+    auto put32 = [&out](uint32_t v) { for (int i = 0; i < 4; ++i) out.put((char)((v >> (8 * i)) & 0xFF)); };
+
+    // BITMAPFILEHEADER
+    out.put('B'); out.put('M');
+    put32(headerSize + imageSize);
+    put32(0);
+    put32(headerSize);
+    // BITMAPINFOHEADER (negative height = top-down rows)
+    put32(40);
+    put32((uint32_t)fb.width());
+    put32((uint32_t)(-fb.height()));
+    put16(1);
+    put16(32);
+    put32(0); // BI_RGB
+    put32(imageSize);
+    put32(2835); // 72 DPI
+    put32(2835);
+    put32(0);
+    put32(0);
+
+    for (int y = 0; y < fb.height(); ++y) {
+        const uint32_t* src = fb.data() + (size_t)y * fb.stride();
+        out.write(reinterpret_cast<const char*>(src), (size_t)fb.width() * 4);
+    }
+    return (bool)out;
+}
@@ -26,12 +26,14 @@ void test_inside() {
 }
 
 void test_clip_point_square() {
-    // This is a visual test, but we can check logic by calling the function
-    // and ensuring no crash. (No assert here)
-    HDC hdc = nullptr; // Not used in logic
+    // Render into an in-memory framebuffer so the result can be checked
+    std::vector<uint32_t> pixels(200 * 200, 0x00FFFFFF);
+    FramebufferSink fb(pixels.data(), 200, 200);
     Clipping::SetClipWindow(0, 0, 100, 100);
-    Clipping::ClipPointSquare(hdc, 50, 50, RGB(0,0,0));
-    Clipping::ClipPointSquare(hdc, 150, 150, RGB(0,0,0));
+    Clipping::ClipPointSquare(fb, 50, 50, RGB(0,0,0));
+    Clipping::ClipPointSquare(fb, 150, 150, RGB(0,0,0));
+    assert(fb.getPixel(50, 50) == RGB(0,0,0));
+    assert(fb.getPixel(150, 150) == RGB(255,255,255));
 }
 
 void test_computeCode() {
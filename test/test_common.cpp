@@ -0,0 +1,72 @@
+#include "../include/common.h"
+#include "../include/curves_third_degree.h"
+#include "../include/tasks_and_assignments.h"
+#include "../src/common.cpp"
+#include "../src/curves_third_degree.cpp"
+#include "../src/cardinal_spline.cpp"
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <iostream>
+
+// Counts heap allocations made by the code under test
+static size_t allocations = 0;
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// Discards pixels, so a benchmark measures only the curve evaluation
+struct NullSink {
+    size_t pixels = 0;
+    void setPixel(int, int, COLORREF) { ++pixels; }
+};
+
+// Products are evaluated at compile time
+static_assert(Common::matrixMult(CurveBasis::Bezier, Vec4{{0, 0, 0, 1}})[0] == 1, "Bezier t^3 coefficient of p4");
+static_assert(Common::matrixMult(CurveBasis::Hermite, Vec4{{5, 5, 0, 0}})[3] == 5, "Hermite constant term is p1");
+
+void test_matrix_mult() {
+    // Bezier control points (0, 10, 20, 30) are the straight line 30t
+    Vec4 line = Common::matrixMult(CurveBasis::Bezier, Vec4{{0, 10, 20, 30}});
+    assert(line[0] == 0 && line[1] == 0 && line[2] == 30 && line[3] == 0);
+    // Hermite end points (1, 2) with tangents (3, 4)
+    Vec4 h = Common::matrixMult(CurveBasis::Hermite, Vec4{{1, 2, 3, 4}});
+    assert(h[0] == 2 * 1 - 2 * 2 + 3 + 4 && h[1] == -3 * 1 + 3 * 2 - 2 * 3 - 4 && h[2] == 3 && h[3] == 1);
+    // A B-spline over collinear, evenly spaced points is the same line, scaled by 6
+    Vec4 b = Common::matrixMult(CurveBasis::BSpline6, Vec4{{0, 6, 12, 18}});
+    assert(b[0] == 0 && b[1] == 0 && b[2] == 36 && b[3] == 36);
+    // Cardinal with s = 1/2 is Catmull-Rom: passes p1 at t = 0 and p2 at t = 1
+    Vec<double, 4> cr = Common::matrixMult(CurveBasis::Cardinal(0.5), Vec<double, 4>{{3, 7, 1, 9}});
+    assert(cr[3] == 7);
+    assert(cr[0] + cr[1] + cr[2] + cr[3] == 1);
+    assert(cr[2] == 0.5 * (1 - 3));
+}
+
+void benchmark_curves_do_not_allocate() {
+    const int curves = 100000;
+    NullSink sink;
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < curves; i++) {
+        int o = i % 64;
+        ThirdDegreeCurve::BezierCurve(sink, o, o, o + 30, o - 20, o + 60, o + 40, o + 90, o, RGB(0, 0, 0));
+        ThirdDegreeCurve::HermiteCurve(sink, o, o, 40, -30, o + 90, o, 40, 30, RGB(0, 0, 0));
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    assert(allocations == before);
+    assert(sink.pixels > 0);
+    std::cout << "Bezier + Hermite: " << ns / curves << " ns per pair, " << (allocations - before) << " allocations\n";
+}
+
+int main() {
+    test_matrix_mult();
+    benchmark_curves_do_not_allocate();
+    std::cout << "All Common unit tests passed!\n";
+    return 0;
+}
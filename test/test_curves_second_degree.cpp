@@ -0,0 +1,506 @@
+#include "../include/curves_second_degree.h"
+#include "../include/circle_cache.h"
+#include "../include/ellipse.h"
+#include "../include/pixel_sink.h"
+#include "../src/common.cpp"
+#include "../src/circle_cache.cpp"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include <iostream>
+
+// Counts how often each pixel is written, through pixels and spans
+struct HitSink {
+    std::map<std::pair<int, int>, int> hits;
+    size_t spans = 0;
+    void setPixel(int x, int y, COLORREF) { hits[{x, y}]++; }
+    void fillSpan(int y, int x0, int x1, COLORREF) {
+        spans++;
+        for (int x = x0; x <= x1; x++) hits[{x, y}]++;
+    }
+    RECT bounds() const { return RECT{INT_MIN, INT_MIN, INT_MAX, INT_MAX}; }
+};
+
+// HitSink whose bounds are a window, as a zoomed-in view
+struct WindowSink : HitSink {
+    RECT window;
+    explicit WindowSink(RECT window) : window(window) {}
+    void setPixel(int x, int y, COLORREF c) {
+        assert(x >= window.left && x < window.right && y >= window.top && y < window.bottom);
+        HitSink::setPixel(x, y, c);
+    }
+    void fillSpan(int y, int x0, int x1, COLORREF c) {
+        assert(x0 >= window.left && x1 < window.right && y >= window.top && y < window.bottom);
+        HitSink::fillSpan(y, x0, x1, c);
+    }
+    RECT bounds() const { return window; }
+};
+
+// The hits of a full drawing that fall inside a window
+static std::map<std::pair<int, int>, int> inside(const HitSink& full, RECT w) {
+    std::map<std::pair<int, int>, int> out;
+    for (const auto& hit : full.hits)
+        if (hit.first.first >= w.left && hit.first.first < w.right && hit.first.second >= w.top && hit.first.second < w.bottom)
+            out.insert(hit);
+    return out;
+}
+
+// The pow-based midpoint circle BresenhamCircle used before the integer decision value
+static std::set<std::pair<int, int>> pow_circle(int xc, int yc, int r, std::pair<int, int>& last) {
+    std::set<std::pair<int, int>> out;
+    auto eight = [&](int x, int y) {
+        int dx[8] = {x, -x, x, -x, y, -y, y, -y};
+        int dy[8] = {y, y, -y, -y, x, x, -x, -x};
+        for (int i = 0; i < 8; i++) out.insert({xc + dx[i], yc + dy[i]});
+    };
+    int x2 = 0, y2 = r;
+    eight(x2, y2);
+    while (x2 < y2) {
+        int d = Common::Round(pow(x2 + 1, 2) + pow(y2 - 0.5, 2) - pow(r, 2));
+        x2++;
+        if (d > 0) y2--;
+        eight(x2, y2);
+    }
+    last = {x2, y2};
+    return out;
+}
+
+void test_midpoint_circle_matches_pow_version() {
+    for (int r = 0; r <= 400; r++) {
+        std::pair<int, int> expectedLast;
+        std::set<std::pair<int, int>> expected = pow_circle(500, 500, r, expectedLast);
+        HitSink sink;
+        std::pair<int, int> last = SecondDegreeCurve::BresenhamCircle(sink, 500, 500, r, RGB(0, 0, 0));
+        assert(last == expectedLast);
+        assert(sink.hits.size() == expected.size());
+        for (const auto& hit : sink.hits) {
+            assert(expected.count(hit.first));
+            assert(hit.second == 1); // no pixel written twice
+        }
+    }
+}
+
+void test_filled_circle_spans() {
+    for (int r = 0; r <= 300; r++) {
+        HitSink disk;
+        SecondDegreeCurve::MidpointCircle(disk, 0, 0, r, RGB(0, 0, 0), true);
+        // One span per row, each pixel written once
+        assert(disk.spans == (size_t)(2 * r + 1));
+        std::map<int, std::pair<int, int>> rows;
+        for (const auto& hit : disk.hits) {
+            assert(hit.second == 1);
+            int x = hit.first.first, y = hit.first.second;
+            auto it = rows.find(y);
+            if (it == rows.end()) rows[y] = {x, x};
+            else it->second = {std::min(it->second.first, x), std::max(it->second.second, x)};
+        }
+        // The disk is exactly the outline's rows filled between their outermost pixels
+        HitSink outline;
+        SecondDegreeCurve::MidpointCircle(outline, 0, 0, r, RGB(0, 0, 0));
+        std::map<int, std::pair<int, int>> outer;
+        for (const auto& hit : outline.hits) {
+            int x = hit.first.first, y = hit.first.second;
+            auto it = outer.find(y);
+            if (it == outer.end()) outer[y] = {x, x};
+            else it->second = {std::min(it->second.first, x), std::max(it->second.second, x)};
+        }
+        assert(rows == outer);
+    }
+}
+
+void test_circle_algorithms_write_each_pixel_once() {
+    // Draw8Points no longer repeats the axis and diagonal reflections
+    HitSink sink;
+    SecondDegreeCurve::ModfiedBresenhamcircle(sink, 50, 50, 30, RGB(0, 0, 0));
+    for (const auto& hit : sink.hits) assert(hit.second == 1);
+    HitSink dot;
+    SecondDegreeCurve::Draw8Points(dot, 5, 5, 0, 0, RGB(0, 0, 0));
+    assert(dot.hits.size() == 1 && dot.hits.begin()->second == 1);
+}
+
+void test_circle_cache_replays_algorithms() {
+    CircleCache cache;
+    const CircleAlgorithm algs[] = {CIRCLE_DIRECT, CIRCLE_POLAR, CIRCLE_ITERATIVE_POLAR, CIRCLE_MIDPOINT, CIRCLE_MODIFIED_MIDPOINT};
+    for (CircleAlgorithm alg : algs) {
+        for (int r = 1; r <= 120; r += 7) {
+            HitSink direct;
+            CircleCache::Rasterize(direct, alg, 300, 200, r, RGB(0, 0, 0));
+            // Miss, then hits at other centers: same pixels, moved, each written once
+            for (int i = 0; i < 3; i++) {
+                HitSink cached;
+                cache.Draw(cached, alg, 300 + 17 * i, 200 - 5 * i, r, RGB(0, 0, 0));
+                assert(cached.hits.size() == direct.hits.size());
+                for (const auto& hit : cached.hits) {
+                    assert(hit.second == 1);
+                    assert(direct.hits.count({hit.first.first - 17 * i, hit.first.second + 5 * i}));
+                }
+            }
+        }
+    }
+    assert(cache.misses == 5 * 18);
+    assert(cache.hits == 2 * 5 * 18);
+}
+
+void test_circle_cache_budget() {
+    CircleCache cache(4096);
+    HitSink sink;
+    for (int r = 10; r < 200; r += 10) cache.Draw(sink, CIRCLE_MIDPOINT, 0, 0, r, RGB(0, 0, 0));
+    assert(cache.used() <= cache.budget());
+    assert(cache.evictions > 0);
+    // The most recent radius is kept, the oldest was evicted
+    size_t hits = cache.hits;
+    cache.Draw(sink, CIRCLE_MIDPOINT, 0, 0, 190, RGB(0, 0, 0));
+    assert(cache.hits == hits + 1);
+    size_t misses = cache.misses;
+    cache.Draw(sink, CIRCLE_MIDPOINT, 0, 0, 10, RGB(0, 0, 0));
+    assert(cache.misses == misses + 1);
+    size_t evictions = cache.evictions;
+    // A circle larger than the budget is drawn but not cached, nor rasterized for the cache
+    HitSink big;
+    size_t before = cache.size(), used = cache.used();
+    cache.Draw(big, CIRCLE_MIDPOINT, 0, 0, 5000, RGB(0, 0, 0));
+    assert(big.hits.size() > 5000 && cache.used() <= cache.budget());
+    assert(cache.size() == before && cache.used() == used && cache.evictions == evictions);
+    for (const auto& hit : big.hits) assert(hit.second == 1);
+    cache.setBudget(0);
+    assert(cache.size() == 0 && cache.used() == 0);
+}
+
+// First-quadrant pixels of the floating point midpoint ellipse DrawEllipseMidPoint used before
+// the integer decision values (int terms, so only for radii up to a few hundred)
+static std::set<std::pair<int, int>> double_ellipse(int a, int b) {
+    std::set<std::pair<int, int>> out;
+    int x = 0, y = b;
+    double d = b * b - a * a * b + 0.25 * a * a;
+    while (b * b * x <= a * a * y) {
+        out.insert({x, y});
+        if (d < 0) {
+            d += 2 * b * b * (2 * x + 3);
+        } else {
+            d += 2 * b * b * (2 * x + 3) - 4 * a * a * (y - 1);
+            y--;
+        }
+        x++;
+    }
+    d = b * b * (x + 0.5) * (x + 0.5) / (a * a) + a * a / 4 - b * b;
+    while (y >= 0) {
+        out.insert({x, y});
+        if (d > 0) {
+            d -= 4 * a * a * (y - 1);
+        } else {
+            d += 2 * b * b * (2 * x + 3);
+            x++;
+        }
+        y--;
+    }
+    return out;
+}
+
+// The same recurrence scaled to integers (4d, then 4a^2 d) in 128 bits, exact for any radius
+static std::vector<std::pair<int, int>> wide_ellipse(long long a, long long b) {
+    std::vector<std::pair<int, int>> out;
+    __int128 a2 = a * a, b2 = b * b;
+    __int128 x = 0, y = b;
+    __int128 d = 4 * b2 - 4 * a2 * b + a2;
+    while (b2 * x <= a2 * y) {
+        out.push_back({(int)x, (int)y});
+        if (d < 0) {
+            d += 8 * b2 * (2 * x + 3);
+        } else {
+            d += 8 * b2 * (2 * x + 3) - 16 * a2 * (y - 1);
+            y--;
+        }
+        x++;
+    }
+    d = b2 * (2 * x + 1) * (2 * x + 1) + 4 * a2 * (a2 / 4) - 4 * a2 * b2;
+    while (y >= 0) {
+        out.push_back({(int)x, (int)y});
+        if (d > 0) {
+            d -= 16 * a2 * a2 * (y - 1);
+        } else {
+            d += 8 * a2 * b2 * (2 * x + 3);
+            x++;
+        }
+        y--;
+    }
+    return out;
+}
+
+// Records pixels of the first quadrant only; its bounds make the ellipse cull the others
+struct QuadrantSink {
+    RECT window;
+    std::vector<std::pair<int, int>> pixels;
+    size_t spans = 0;
+    void setPixel(int x, int y, COLORREF) { pixels.push_back({x - (int)window.left, y - (int)window.top}); }
+    void fillSpan(int y, int x0, int x1, COLORREF c) {
+        spans++;
+        for (int x = x0; x <= x1; x++) setPixel(x, y, c);
+    }
+    RECT bounds() const { return window; }
+};
+
+void test_midpoint_ellipse_matches_double_version() {
+    auto check = [](int a, int b) {
+        std::set<std::pair<int, int>> quadrant = double_ellipse(a, b);
+        std::set<std::pair<int, int>> expected;
+        for (const auto& p : quadrant) {
+            for (int sx = -1; sx <= 1; sx += 2)
+                for (int sy = -1; sy <= 1; sy += 2) expected.insert({300 + sx * p.first, 300 + sy * p.second});
+        }
+        HitSink sink;
+        Ellipse::DrawEllipseMidPoint(sink, 300, 300, a, b, RGB(0, 0, 0));
+        assert(sink.hits.size() == expected.size());
+        for (const auto& hit : sink.hits) assert(expected.count(hit.first) && hit.second == 1);
+    };
+    for (int a = 1; a <= 60; a++)
+        for (int b = 1; b <= 60; b++) check(a, b);
+    for (int a = 7; a <= 500; a += 37)
+        for (int b = 3; b <= 500; b += 41) check(a, b);
+}
+
+void test_filled_ellipse_spans() {
+    for (int a = 1; a <= 80; a += 3) {
+        for (int b = 1; b <= 80; b += 5) {
+            HitSink disk, outline;
+            Ellipse::DrawEllipseMidPoint(disk, 0, 0, a, b, RGB(0, 0, 0), true);
+            Ellipse::DrawEllipseMidPoint(outline, 0, 0, a, b, RGB(0, 0, 0));
+            // One span per row, filling the outline's rows between their outermost pixels
+            assert(disk.spans == (size_t)(2 * b + 1));
+            std::map<int, std::pair<int, int>> rows, outer;
+            for (const auto& hit : disk.hits) {
+                assert(hit.second == 1);
+                auto it = rows.find(hit.first.second);
+                if (it == rows.end()) rows[hit.first.second] = {hit.first.first, hit.first.first};
+                else it->second = {std::min(it->second.first, hit.first.first), std::max(it->second.second, hit.first.first)};
+            }
+            for (const auto& hit : outline.hits) {
+                auto it = outer.find(hit.first.second);
+                if (it == outer.end()) outer[hit.first.second] = {hit.first.first, hit.first.first};
+                else it->second = {std::min(it->second.first, hit.first.first), std::max(it->second.second, hit.first.first)};
+            }
+            assert(rows == outer);
+            assert(disk.hits.size() == [&] { size_t n = 0; for (const auto& r : rows) n += r.second.second - r.second.first + 1; return n; }());
+        }
+    }
+}
+
+void test_midpoint_ellipse_large_radii() {
+    const int radii[][2] = {{1000000, 1000000}, {1000000, 300000}, {250000, 1000000}, {1000000, 1}, {1, 1000000}, {999999, 999998}};
+    for (const auto& r : radii) {
+        QuadrantSink sink;
+        sink.window = {0, 0, INT_MAX, INT_MAX};
+        Ellipse::DrawEllipseMidPoint(sink, 0, 0, r[0], r[1], RGB(0, 0, 0));
+        std::vector<std::pair<int, int>> expected = wide_ellipse(r[0], r[1]);
+        std::sort(sink.pixels.begin(), sink.pixels.end());
+        std::sort(expected.begin(), expected.end());
+        assert(sink.pixels == expected);
+        assert(std::binary_search(expected.begin(), expected.end(), std::make_pair(0, r[1])));
+        assert(std::any_of(expected.begin(), expected.end(), [](const std::pair<int, int>& p) { return p.second == 0; }));
+    }
+    // Rows of the flat parts are written as spans, not pixel by pixel
+    QuadrantSink flat;
+    flat.window = {0, 0, 1000001, 1001};
+    Ellipse::DrawEllipseMidPoint(flat, 0, 0, 1000000, 1000, RGB(0, 0, 0));
+    assert(flat.spans <= 1001 && flat.pixels.size() > 999000);
+}
+
+// DrawEllipsePolar before the rotation recurrence: cos and sin at every sample
+static std::set<std::pair<int, int>> trig_ellipse(int xc, int yc, int a, int b) {
+    std::set<std::pair<int, int>> out;
+    double step = 1.0 / std::max(a, b);
+    for (double angle = 0.0; angle < 2 * M_PI; angle += step)
+        out.insert({Common::Round(xc + a * cos(angle)), Common::Round(yc + b * sin(angle))});
+    return out;
+}
+
+void test_polar_ellipse_matches_trig_version() {
+    auto check = [](int a, int b) {
+        std::set<std::pair<int, int>> expected = trig_ellipse(400, 300, a, b);
+        HitSink sink;
+        Ellipse::DrawEllipsePolar(sink, 400, 300, a, b, RGB(0, 0, 0));
+        assert(sink.hits.size() == expected.size());
+        for (const auto& hit : sink.hits) assert(expected.count(hit.first));
+    };
+    for (int a = 1; a <= 150; a++)
+        for (int b = 1; b <= 150; b += 7) check(a, b);
+    check(3000, 1200);
+    check(517, 4096);
+}
+
+void test_polar_circle_matches_sqrt_version() {
+    for (int r = 0; r <= 600; r++) {
+        // The x2, y2 form as the UI passes it: a point on the rim
+        int x2 = 250 + r * 3 / 5, y2 = 250 - r * 4 / 5;
+        int rr = Common::Round(sqrt(abs((250 - x2) * (250 - x2) + (250 - y2) * (250 - y2))));
+        std::set<std::pair<int, int>> expected;
+        for (int x = 0; x >= -rr; x--) {
+            int y = Common::Round(sqrt(rr * rr - x * x));
+            int dx[8] = {x, -x, x, -x, y, -y, y, -y};
+            int dy[8] = {y, y, -y, -y, x, x, -x, -x};
+            for (int i = 0; i < 8; i++) expected.insert({250 + dx[i], 250 + dy[i]});
+        }
+        HitSink sink;
+        SecondDegreeCurve::DrawCircle(sink, 250, 250, x2, y2, RGB(0, 0, 0));
+        assert(sink.hits.size() == expected.size());
+        for (const auto& hit : sink.hits) assert(expected.count(hit.first));
+    }
+}
+
+void test_circle_draws_only_visible_arcs() {
+    const RECT windows[] = {{0, 0, 40, 40}, {90, 95, 130, 101}, {-20, 60, 310, 61}, {100, 100, 101, 400}, {-500, -500, 500, 500}, {150, 150, 170, 170}};
+    for (int r = 0; r <= 150; r += 3) {
+        HitSink full, fullDisk;
+        std::pair<int, int> fullLast = SecondDegreeCurve::MidpointCircle(full, 100, 100, r, RGB(0, 0, 0));
+        SecondDegreeCurve::MidpointCircle(fullDisk, 100, 100, r, RGB(0, 0, 0), true);
+        for (const RECT& w : windows) {
+            WindowSink outline(w), disk(w);
+            std::pair<int, int> last = SecondDegreeCurve::MidpointCircle(outline, 100, 100, r, RGB(0, 0, 0));
+            SecondDegreeCurve::MidpointCircle(disk, 100, 100, r, RGB(0, 0, 0), true);
+            assert(last == fullLast);
+            assert(outline.hits == inside(full, w));
+            assert(disk.hits.size() == inside(fullDisk, w).size());
+            for (const auto& hit : disk.hits) assert(hit.second == 1 && fullDisk.hits.count(hit.first));
+        }
+    }
+
+    // A window on the rim of a huge circle: the visible pixels match a full integer walk,
+    // and the walk itself only covers the visible arcs
+    const int r = 1000000;
+    RECT w = {r - 60, 200, r + 60, 320};
+    WindowSink rim(w);
+    SecondDegreeCurve::MidpointCircle(rim, 0, 0, r, RGB(0, 0, 0));
+    std::set<std::pair<int, int>> expected;
+    long long x = 0, y = r, d = 1 - r;
+    while (x <= y) {
+        int dx[8] = {(int)x, (int)-x, (int)x, (int)-x, (int)y, (int)-y, (int)y, (int)-y};
+        int dy[8] = {(int)y, (int)y, (int)-y, (int)-y, (int)x, (int)x, (int)-x, (int)-x};
+        for (int i = 0; i < 8; i++)
+            if (dx[i] >= w.left && dx[i] < w.right && dy[i] >= w.top && dy[i] < w.bottom) expected.insert({dx[i], dy[i]});
+        bool stepY = d > 0;
+        x++;
+        d += 2 * x + 1;
+        if (stepY) d -= 2 * --y;
+    }
+    assert(!expected.empty() && rim.hits.size() == expected.size());
+    for (const auto& hit : rim.hits) assert(expected.count(hit.first) && hit.second == 1);
+
+    // Off-screen circles write nothing
+    WindowSink away({0, 0, 10, 10});
+    SecondDegreeCurve::MidpointCircle(away, 500, 500, 100, RGB(0, 0, 0));
+    SecondDegreeCurve::MidpointCircle(away, 500, 500, 100, RGB(0, 0, 0), true);
+    CircleCache cache;
+    cache.Draw(away, CIRCLE_DIRECT, 500, 500, 100, RGB(0, 0, 0));
+    assert(away.hits.empty() && cache.misses == 0);
+}
+
+void test_circle_cache_clips_to_view() {
+    CircleCache cache;
+    const CircleAlgorithm algs[] = {CIRCLE_DIRECT, CIRCLE_POLAR, CIRCLE_ITERATIVE_POLAR, CIRCLE_MIDPOINT, CIRCLE_MODIFIED_MIDPOINT};
+    RECT w = {120, 80, 200, 140};
+    for (CircleAlgorithm alg : algs) {
+        HitSink full;
+        CircleCache::Rasterize(full, alg, 150, 100, 60, RGB(0, 0, 0));
+        WindowSink cut(w);
+        cache.Draw(cut, alg, 150, 100, 60, RGB(0, 0, 0));
+        // The same pixels as drawing it whole, each written once
+        std::map<std::pair<int, int>, int> expected = inside(full, w);
+        assert(!expected.empty() && cut.hits.size() == expected.size());
+        for (const auto& hit : cut.hits) assert(expected.count(hit.first) && hit.second == 1);
+    }
+}
+
+void test_ellipses_draw_only_visible_pixels() {
+    const RECT windows[] = {{0, 0, 50, 50}, {180, 90, 260, 95}, {195, 0, 205, 400}, {-100, -100, 600, 600}};
+    for (int a = 0; a <= 120; a += 17) {
+        for (int b = 1; b <= 90; b += 11) {
+            HitSink eq, mid, polar;
+            Ellipse::DrawEllipseEquation(eq, 200, 150, a, b, RGB(0, 0, 0));
+            Ellipse::DrawEllipsePolar(polar, 200, 150, a, b, RGB(0, 0, 0));
+            if (a > 0) Ellipse::DrawEllipseMidPoint(mid, 200, 150, a, b, RGB(0, 0, 0));
+            for (const RECT& w : windows) {
+                WindowSink eqCut(w), midCut(w), polarCut(w);
+                Ellipse::DrawEllipseEquation(eqCut, 200, 150, a, b, RGB(0, 0, 0));
+                Ellipse::DrawEllipsePolar(polarCut, 200, 150, a, b, RGB(0, 0, 0));
+                if (a > 0) Ellipse::DrawEllipseMidPoint(midCut, 200, 150, a, b, RGB(0, 0, 0));
+                assert(eqCut.hits == inside(eq, w));
+                assert(polarCut.hits == inside(polar, w));
+                assert(midCut.hits == inside(mid, w));
+            }
+        }
+    }
+}
+
+void test_ellipses_seek_visible_arcs() {
+    // Small windows swept across the ellipses: the same pixels and write counts as a whole draw
+    const int shapes[][2] = {{1, 9}, {9, 1}, {2, 30}, {23, 17}, {40, 12}, {13, 45}, {120, 80}};
+    for (const auto& r : shapes) {
+        HitSink mid, polar;
+        Ellipse::DrawEllipseMidPoint(mid, 0, 0, r[0], r[1], RGB(0, 0, 0));
+        Ellipse::DrawEllipsePolar(polar, 0, 0, r[0], r[1], RGB(0, 0, 0));
+        for (int left = -r[0] - 8; left <= r[0] + 2; left += 3) {
+            for (int top = -r[1] - 6; top <= r[1] + 2; top += 4) {
+                RECT w = {left, top, left + 7, top + 5};
+                WindowSink midCut(w), polarCut(w);
+                Ellipse::DrawEllipseMidPoint(midCut, 0, 0, r[0], r[1], RGB(0, 0, 0));
+                Ellipse::DrawEllipsePolar(polarCut, 0, 0, r[0], r[1], RGB(0, 0, 0));
+                assert(midCut.hits == inside(mid, w));
+                assert(polarCut.hits == inside(polar, w));
+            }
+        }
+    }
+
+    // Views of large ellipses start the walk at their arc: near the ends of the axes, on the
+    // diagonal and in region 2, in every quadrant
+    const long long radii[][2] = {{1000000, 1000000}, {1000000, 300000}, {250000, 1000000}, {3, 1000000}, {1000000, 7}};
+    for (const auto& r : radii) {
+        std::vector<std::pair<int, int>> quadrant = wide_ellipse(r[0], r[1]);
+        const std::pair<int, int>& diagonal = quadrant[quadrant.size() / 2];
+        const std::pair<int, int>& lower = quadrant[quadrant.size() * 7 / 8];
+        const RECT windows[] = {
+            {(LONG)r[0] - 40, -15, (LONG)r[0] + 3, 15},
+            {-20, -(LONG)r[1] - 3, 20, -(LONG)r[1] + 30},
+            {-diagonal.first - 10, diagonal.second - 10, -diagonal.first + 10, diagonal.second + 10},
+            {lower.first - 6, -lower.second - 6, lower.first + 6, -lower.second + 6},
+            {-10, -10, 10, 10},
+        };
+        for (const RECT& w : windows) {
+            std::set<std::pair<int, int>> expected;
+            for (const auto& p : quadrant) {
+                for (int sx = -1; sx <= 1; sx += 2) {
+                    for (int sy = -1; sy <= 1; sy += 2) {
+                        int x = sx * p.first, y = sy * p.second;
+                        if (x >= w.left && x < w.right && y >= w.top && y < w.bottom) expected.insert({x, y});
+                    }
+                }
+            }
+            WindowSink cut(w);
+            Ellipse::DrawEllipseMidPoint(cut, 0, 0, (int)r[0], (int)r[1], RGB(0, 0, 0));
+            assert(cut.hits.size() == expected.size());
+            for (const auto& hit : cut.hits) assert(expected.count(hit.first) && hit.second == 1);
+        }
+    }
+}
+
+int main() {
+    test_midpoint_circle_matches_pow_version();
+    test_filled_circle_spans();
+    test_circle_algorithms_write_each_pixel_once();
+    test_circle_cache_replays_algorithms();
+    test_circle_cache_budget();
+    test_circle_draws_only_visible_arcs();
+    test_midpoint_ellipse_matches_double_version();
+    test_filled_ellipse_spans();
+    test_midpoint_ellipse_large_radii();
+    test_polar_ellipse_matches_trig_version();
+    test_polar_circle_matches_sqrt_version();
+    test_circle_cache_clips_to_view();
+    test_ellipses_draw_only_visible_pixels();
+    test_ellipses_seek_visible_arcs();
+    std::cout << "All SecondDegreeCurve unit tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,292 @@
+#include "../include/curves_third_degree.h"
+#include "../include/pixel_sink.h"
+#include "../src/common.cpp"
+#include "../src/curves_third_degree.cpp"
+#include "../src/cardinal_spline.cpp"
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include <utility>
+#include <vector>
+#include <iostream>
+
+// Counts heap allocations, to check evaluators that promise not to allocate
+static size_t allocations = 0;
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// Records the plotted pixels in order
+struct PathSink {
+    std::vector<POINT> pixels;
+    void setPixel(int x, int y, COLORREF) { pixels.push_back(POINT{x, y}); }
+};
+
+// The pixels of the fixed 10,000-step t loop the curves used before forward differencing
+static std::set<std::pair<int, int>> sampled_bezier(int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4) {
+    std::set<std::pair<int, int>> out;
+    for (int i = 0; i <= 10000; i++) {
+        double t = i / 10000.0, s = 1 - t;
+        double x = s * s * s * x1 + 3 * s * s * t * x2 + 3 * s * t * t * x3 + t * t * t * x4;
+        double y = s * s * s * y1 + 3 * s * s * t * y2 + 3 * s * t * t * y3 + t * t * t * y4;
+        out.insert({Common::Round(x), Common::Round(y)});
+    }
+    return out;
+}
+
+// Consecutive pixels are 8-neighbours and never repeat the previous one
+static void assert_connected(const std::vector<POINT>& path) {
+    for (size_t i = 1; i < path.size(); i++) {
+        long dx = std::labs(path[i].x - path[i - 1].x), dy = std::labs(path[i].y - path[i - 1].y);
+        assert(dx <= 1 && dy <= 1 && dx + dy > 0);
+    }
+}
+
+void test_bezier_forward_differences() {
+    srand(16);
+    for (int i = 0; i < 200; i++) {
+        int p[8];
+        for (int& v : p) v = 20 + rand() % 600;
+        PathSink path;
+        ThirdDegreeCurve::BezierCurve(path, p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], RGB(0, 0, 0));
+        assert_connected(path.pixels);
+        assert(path.pixels.front().x == p[0] && path.pixels.front().y == p[1]);
+        assert(path.pixels.back().x == p[6] && path.pixels.back().y == p[7]);
+        // Every pixel lies on (or next to) the curve the sampled loop drew
+        std::set<std::pair<int, int>> sampled = sampled_bezier(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+        for (const POINT& q : path.pixels) {
+            bool near = false;
+            for (int dy = -1; dy <= 1 && !near; dy++)
+                for (int dx = -1; dx <= 1 && !near; dx++)
+                    near = sampled.count({q.x + dx, q.y + dy}) > 0;
+            assert(near);
+        }
+    }
+}
+
+void test_hermite_forward_differences() {
+    PathSink path;
+    ThirdDegreeCurve::HermiteCurve(path, 100, 100, 300, -50, 400, 250, -200, 120, RGB(0, 0, 0));
+    assert_connected(path.pixels);
+    assert(path.pixels.front().x == 100 && path.pixels.front().y == 100);
+    assert(path.pixels.back().x == 400 && path.pixels.back().y == 250);
+}
+
+void test_small_curves_are_cheap() {
+    std::vector<uint32_t> pixels(16 * 16, 0);
+    FramebufferSink fb(pixels.data(), 16, 16);
+    CountingSink<FramebufferSink> counter(fb);
+    ThirdDegreeCurve::BezierCurve(counter, 2, 2, 4, 1, 6, 5, 8, 4, RGB(0, 0, 0));
+    assert(counter.writes <= 10);
+    // A degenerate curve is a single pixel
+    PathSink dot;
+    ThirdDegreeCurve::BezierCurve(dot, 5, 5, 5, 5, 5, 5, 5, 5, RGB(0, 0, 0));
+    assert(dot.pixels.size() == 1);
+}
+
+void test_flatten_bezier() {
+    std::vector<double> control = {20, 300, 120, 20, 380, 580, 480, 300};
+    std::set<std::pair<int, int>> sampled = sampled_bezier(20, 300, 120, 20, 380, 580, 480, 300);
+    for (double tolerance : {0.25, 0.5, 2.0}) {
+        std::vector<POINT> polyline;
+        ThirdDegreeCurve::FlattenBezier(control, polyline, tolerance);
+        assert(polyline.front().x == 20 && polyline.front().y == 300);
+        assert(polyline.back().x == 480 && polyline.back().y == 300);
+        // Far fewer vertices than the sampled loop's 10,000 evaluations, and all on the curve
+        assert(polyline.size() > 4 && polyline.size() < 200);
+        for (const POINT& q : polyline) {
+            bool near = false;
+            for (int dy = -1; dy <= 1 && !near; dy++)
+                for (int dx = -1; dx <= 1 && !near; dx++)
+                    near = sampled.count({q.x + dx, q.y + dy}) > 0;
+            assert(near);
+        }
+    }
+    // Looser tolerances give fewer vertices; a straight curve is a single segment
+    std::vector<POINT> fine, coarse, straight;
+    ThirdDegreeCurve::FlattenBezier(control, fine, 0.1);
+    ThirdDegreeCurve::FlattenBezier(control, coarse, 4.0);
+    assert(coarse.size() < fine.size());
+    ThirdDegreeCurve::FlattenBezier({0, 0, 10, 10, 20, 20, 30, 30}, straight);
+    assert(straight.size() == 2);
+    // Higher degrees flatten the same way
+    std::vector<POINT> quintic;
+    ThirdDegreeCurve::FlattenBezier({0, 0, 50, 200, 100, -100, 150, 300, 200, 0, 250, 100}, quintic);
+    assert(quintic.front().x == 0 && quintic.back().x == 250 && quintic.back().y == 100);
+    // Collinear control points past the chord's end are not flat: the curve turns back at x ~ 239.4
+    std::vector<POINT> overshoot;
+    ThirdDegreeCurve::FlattenBezier({0, 0, 300, 0, 300, 0, 100, 0}, overshoot);
+    LONG reach = 0;
+    for (const POINT& q : overshoot) reach = std::max(reach, q.x);
+    assert(overshoot.size() > 2 && reach >= 239 && reach <= 240);
+}
+
+void test_flat_bezier_is_connected() {
+    PathSink path;
+    ThirdDegreeCurve::FlatBezier(path, {20, 300, 120, 20, 380, 580, 480, 300}, RGB(0, 0, 0));
+    for (size_t i = 1; i < path.pixels.size(); i++) {
+        assert(std::labs(path.pixels[i].x - path.pixels[i - 1].x) <= 1);
+        assert(std::labs(path.pixels[i].y - path.pixels[i - 1].y) <= 1);
+    }
+}
+
+// The recursive de Casteljau evaluation Bezier() used to do
+static void de_casteljau(std::vector<double> p, double t, double& x, double& y) {
+    for (size_t n = p.size() / 2; n > 1; n--)
+        for (size_t i = 0; i + 1 < n; i++) {
+            p[2 * i] = (1 - t) * p[2 * i] + t * p[2 * i + 2];
+            p[2 * i + 1] = (1 - t) * p[2 * i + 1] + t * p[2 * i + 3];
+        }
+    x = p[0];
+    y = p[1];
+}
+
+void test_bernstein_evaluator() {
+    srand(18);
+    for (int degree = 0; degree <= 15; degree++) {
+        std::vector<double> points(2 * (degree + 1));
+        for (double& v : points) v = rand() % 800;
+        std::vector<double> t(37), x(37), y(37);
+        for (size_t i = 0; i < t.size(); i++) t[i] = i / 36.0;
+        size_t before = allocations;
+        ThirdDegreeCurve::EvaluateBezier(points, t.data(), t.size(), x.data(), y.data());
+        ThirdDegreeCurve::EvaluateBezier(points, t.data(), t.size(), x.data(), y.data());
+        // The scratch buffer only grows for a new, larger degree
+        assert(allocations - before <= 2);
+        for (size_t i = 0; i < t.size(); i++) {
+            double ex, ey;
+            de_casteljau(points, t[i], ex, ey);
+            assert(std::fabs(x[i] - ex) < 1e-6 && std::fabs(y[i] - ey) < 1e-6);
+        }
+        std::vector<double> single = ThirdDegreeCurve::Bezier(points, 0.3);
+        double ex, ey;
+        de_casteljau(points, 0.3, ex, ey);
+        assert(std::fabs(single[0] - ex) < 1e-6 && std::fabs(single[1] - ey) < 1e-6);
+    }
+}
+
+void test_rec_bezier_does_not_allocate() {
+    std::vector<double> points = {10, 10, 60, 200, 150, -40, 220, 180, 300, 20, 380, 120};
+    PathSink warmup, path;
+    ThirdDegreeCurve::RecBezier(warmup, points, RGB(0, 0, 0));
+    path.pixels.reserve(warmup.pixels.size());
+    size_t before = allocations;
+    ThirdDegreeCurve::RecBezier(path, points, RGB(0, 0, 0));
+    // Only the by-value parameter is copied
+    assert(allocations - before <= 1);
+    assert(path.pixels.size() == warmup.pixels.size());
+    assert(path.pixels.front().x == 10 && path.pixels.front().y == 10);
+    for (size_t i = 1; i < path.pixels.size(); i++) {
+        assert(std::labs(path.pixels[i].x - path.pixels[i - 1].x) <= 1);
+        assert(std::labs(path.pixels[i].y - path.pixels[i - 1].y) <= 1);
+    }
+}
+
+static bool same_polyline(const std::vector<POINT>& a, const std::vector<POINT>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++)
+        if (a[i].x != b[i].x || a[i].y != b[i].y) return false;
+    return true;
+}
+
+void test_cardinal_spline_appends_incrementally() {
+    srand(20);
+    std::vector<double> points;
+    CardinalSpline spline(0.8);
+    for (int i = 0; i < 3000; i++) {
+        double x = 20 + rand() % 760, y = 20 + rand() % 560;
+        points.push_back(x);
+        points.push_back(y);
+        size_t before = spline.flattened;
+        spline.append(x, y);
+        // Only the new segment and the one before it are flattened again
+        assert(spline.flattened - before <= 2);
+    }
+    assert(spline.segmentCount() == spline.pointCount() - 1);
+
+    // Same segments as flattening the whole spline at once
+    CardinalSpline whole(0.8);
+    whole.assign(points);
+    for (size_t i = 0; i < whole.segmentCount(); i++) {
+        assert(same_polyline(whole.segment(i), spline.segment(i)));
+    }
+    // The first and last segments are drawn, ending on the first and last points
+    assert(whole.segment(0).front().x == points[0] && whole.segment(0).front().y == points[1]);
+    const std::vector<POINT>& last = whole.segment(whole.segmentCount() - 1);
+    assert(last.back().x == points[points.size() - 2] && last.back().y == points.back());
+
+    // Changing the tension flattens every segment again
+    size_t before = whole.flattened;
+    whole.setTension(0.2);
+    assert(whole.flattened - before == whole.segmentCount());
+}
+
+void test_cardinal_spline_overshoot() {
+    // Collinear points whose middle segment overshoots its end points along the line
+    std::vector<double> points = {0, 100, 100, 100, 120, 100, 400, 100};
+    CardinalSpline spline;
+    spline.assign(points);
+    size_t n = points.size() / 2;
+    for (size_t i = 0; i + 1 < n; i++) {
+        // Hermite segment with tangents (p[i+1] - p[i-1]) / 2, end points standing in for missing neighbours
+        double x0 = points[2 * i], x1 = points[2 * i + 2];
+        double t0 = (points[2 * std::min(i + 1, n - 1)] - points[2 * (i > 0 ? i - 1 : i)]) / 2;
+        double t1 = (points[2 * std::min(i + 2, n - 1)] - points[2 * i]) / 2;
+        double lo = 1e9, hi = -1e9;
+        for (int k = 0; k <= 1000; k++) {
+            double t = k / 1000.0, t2 = t * t, t3 = t2 * t;
+            double x = (2 * t3 - 3 * t2 + 1) * x0 + (t3 - 2 * t2 + t) * t0 + (-2 * t3 + 3 * t2) * x1 + (t3 - t2) * t1;
+            lo = std::min(lo, x);
+            hi = std::max(hi, x);
+        }
+        // The cached polyline reaches the curve's extent and the segment's box holds it
+        LONG minX = LONG_MAX, maxX = LONG_MIN;
+        for (const POINT& q : spline.segment(i)) {
+            minX = std::min(minX, q.x);
+            maxX = std::max(maxX, q.x);
+        }
+        assert(minX <= lo + 1 && maxX >= hi - 1);
+        const RECT& box = spline.segmentBounds(i);
+        assert(box.left <= (LONG)std::floor(lo) && box.right > (LONG)std::ceil(hi));
+    }
+}
+
+void test_cardinal_spline_draw_area() {
+    CardinalSpline spline;
+    spline.assign({20, 20, 100, 60, 180, 20, 260, 60, 340, 20, 420, 60});
+    std::vector<uint32_t> pixels(500 * 100, 0);
+    FramebufferSink fb(pixels.data(), 500, 100);
+    CountingSink<FramebufferSink> all(fb), part(fb);
+    spline.Draw(all, RGB(0, 0, 0));
+    // Only the segments whose box meets the area are drawn
+    spline.Draw(part, RGB(0, 0, 0), RECT{0, 0, 60, 100});
+    assert(part.writes > 0 && part.writes < all.writes / 2);
+    // Every vertex, and so every line between them, lies inside its segment's box
+    for (size_t i = 0; i < spline.segmentCount(); i++) {
+        const RECT& box = spline.segmentBounds(i);
+        for (const POINT& p : spline.segment(i))
+            assert(p.x >= box.left && p.x < box.right && p.y >= box.top && p.y < box.bottom);
+    }
+}
+
+int main() {
+    test_bezier_forward_differences();
+    test_hermite_forward_differences();
+    test_small_curves_are_cheap();
+    test_flatten_bezier();
+    test_flat_bezier_is_connected();
+    test_bernstein_evaluator();
+    test_rec_bezier_does_not_allocate();
+    test_cardinal_spline_appends_incrementally();
+    test_cardinal_spline_draw_area();
+    test_cardinal_spline_overshoot();
+    std::cout << "All ThirdDegreeCurve unit tests passed!\n";
+    return 0;
+}
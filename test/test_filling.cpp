@@ -0,0 +1,398 @@
+#include "../include/filling.h"
+#include "../include/layer_renderer.h"
+#include "../include/pixel_sink.h"
+#include "../include/span_mask.h"
+#include "../src/common.cpp"
+#include "../src/circle_cache.cpp"
+#include "../src/curves_third_degree.cpp"
+#include "../src/cardinal_spline.cpp"
+#include "../src/filling.cpp"
+#include "../src/layer_bounds.cpp"
+#include "../src/span_mask.cpp"
+#include <cassert>
+#include <vector>
+#include <iostream>
+
+static const COLORREF WHITE = RGB(255, 255, 255);
+
+void test_span_mask_from_pixels() {
+    std::vector<POINT> pixels = {{3, 1}, {1, 1}, {2, 1}, {5, 1}, {2, 1}, {0, 0}};
+    SpanMask mask = SpanMask::FromPixels(pixels);
+    const std::vector<SpanMask::Span>& spans = mask.spans();
+    assert(spans.size() == 3);
+    assert(spans[0].y == 0 && spans[0].x0 == 0 && spans[0].x1 == 0);
+    assert(spans[1].y == 1 && spans[1].x0 == 1 && spans[1].x1 == 3);
+    assert(spans[2].y == 1 && spans[2].x0 == 5 && spans[2].x1 == 5);
+    assert(mask.pixelCount() == 5);
+}
+
+void test_flood_fill_spans_are_replayed() {
+    const int W = 64, H = 64;
+    COLORREF c = RGB(255, 0, 0);
+    std::vector<Layer> layers = {
+        Layer{LayerRect{{10, 10}, {50, 40}, c}},
+        Layer{LayerFill{{20, 20}, c, FILL_NONRECURSIVE_FLOOD, 0, nullptr, std::nullopt}},
+    };
+    std::vector<uint32_t> first(W * H, FramebufferSink::ToPixel(WHITE));
+    FramebufferSink fb(first.data(), W, H);
+    LayerRenderer::RenderLayers(fb, layers);
+    const LayerFill& fill = std::get<LayerFill>(layers[1].shape);
+    assert(fill.spans);
+    assert(fill.spans->pixelCount() == 39 * 29); // interior of the rectangle
+    assert(fill.spans->spans().size() == 29);    // one run per row
+
+    // The second render replays the runs without reading the target
+    std::vector<uint32_t> second(W * H, FramebufferSink::ToPixel(WHITE));
+    FramebufferSink fb2(second.data(), W, H);
+    LayerRenderer::RenderLayer(fb2, layers, layers[0]);
+    CountingSink<FramebufferSink> counter(fb2);
+    LayerRenderer::RenderLayer(counter, layers, layers[1]);
+    assert(counter.reads == 0);
+    assert(first == second);
+
+    // Changing an earlier layer drops the recording
+    LayerRenderer::InvalidateFillCaches(layers, 0);
+    assert(!fill.spans);
+}
+
+// Reference 4-connected boundary fill, used to check the optimized fills
+static void reference_fill(std::vector<uint32_t>& pixels, int w, int h, int x, int y, COLORREF color) {
+    uint32_t target = FramebufferSink::ToPixel(color);
+    std::vector<POINT> stack = {POINT{x, y}};
+    while (!stack.empty()) {
+        POINT p = stack.back();
+        stack.pop_back();
+        if (p.x < 0 || p.y < 0 || p.x >= w || p.y >= h) continue;
+        uint32_t& px = pixels[p.y * w + p.x];
+        if (px == target) continue;
+        px = target;
+        stack.push_back(POINT{p.x + 1, p.y});
+        stack.push_back(POINT{p.x - 1, p.y});
+        stack.push_back(POINT{p.x, p.y + 1});
+        stack.push_back(POINT{p.x, p.y - 1});
+    }
+}
+
+// A ring with a notch and an island, so the fill has to turn back into rows it already passed
+static void draw_test_outline(FramebufferSink& fb, COLORREF c) {
+    SecondDegreeCurve::BresenhamCircle(fb, 60, 60, 50, c);
+    SecondDegreeCurve::BresenhamCircle(fb, 60, 60, 15, c);
+    std::vector<POINT> notch = {{20, 20}, {70, 65}, {100, 10}};
+    LayerRenderer::DrawPolygon(fb, notch, c);
+}
+
+void test_scanline_fill_matches_reference() {
+    const int W = 128, H = 128;
+    COLORREF c = RGB(0, 128, 0);
+    std::vector<uint32_t> pixels(W * H, FramebufferSink::ToPixel(WHITE));
+    FramebufferSink fb(pixels.data(), W, H);
+    draw_test_outline(fb, c);
+    std::vector<uint32_t> expected = pixels;
+    reference_fill(expected, W, H, 60, 100, c);
+
+    CountingSink<FramebufferSink> counter(fb);
+    Filling::NonRecursiveFloodFill(counter, 60, 100, c);
+    assert(pixels == expected);
+    // Every pixel is written exactly once
+    size_t filled = 0;
+    for (int i = 0; i < W * H; i++) filled += pixels[i] == FramebufferSink::ToPixel(c);
+    std::vector<uint32_t> outline(W * H, FramebufferSink::ToPixel(WHITE));
+    FramebufferSink outlineFb(outline.data(), W, H);
+    draw_test_outline(outlineFb, c);
+    size_t boundary = 0;
+    for (int i = 0; i < W * H; i++) boundary += outline[i] == FramebufferSink::ToPixel(c);
+    assert(counter.writes == filled - boundary);
+}
+
+void test_scanline_fill_stays_in_bounds() {
+    const int W = 32, H = 32;
+    COLORREF c = RGB(0, 0, 255);
+    std::vector<uint32_t> pixels(W * H, FramebufferSink::ToPixel(WHITE));
+    FramebufferSink fb(pixels.data(), W, H);
+    // No boundary at all: the fill stops at the explicit bounds
+    Filling::NonRecursiveFloodFill(fb, 10, 10, c, RECT{5, 5, 20, 15});
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            bool in = x >= 5 && x < 20 && y >= 5 && y < 15;
+            assert((fb.getPixel(x, y) == c) == in);
+        }
+    }
+    // and at the canvas edge when no bounds are given
+    Filling::NonRecursiveFloodFill(fb, 0, 0, RGB(255, 0, 0));
+    assert(fb.getPixel(31, 31) == RGB(255, 0, 0));
+}
+
+void test_fill_reaching_edge_is_not_cached() {
+    const int W = 16, H = 16;
+    COLORREF c = RGB(0, 0, 255);
+    std::vector<uint32_t> pixels(W * H, FramebufferSink::ToPixel(WHITE));
+    FramebufferSink fb(pixels.data(), W, H);
+    std::vector<Layer> layers = {
+        Layer{LayerRect{{2, 2}, {40, 40}, c}},
+        Layer{LayerFill{{5, 5}, c, FILL_NONRECURSIVE_FLOOD, 0, nullptr, std::nullopt}},
+    };
+    LayerRenderer::RenderLayers(fb, layers);
+    assert(fb.getPixel(15, 15) == c);
+    assert(!std::get<LayerFill>(layers[1].shape).spans);
+}
+
+void test_recursive_fill_large_region() {
+    // Far more pixels than the old one-call-per-pixel recursion could handle
+    const int W = 1500, H = 1000;
+    COLORREF c = RGB(200, 0, 0);
+    std::vector<uint32_t> pixels(W * H, FramebufferSink::ToPixel(WHITE));
+    FramebufferSink fb(pixels.data(), W, H);
+    SecondDegreeCurve::BresenhamCircle(fb, 700, 500, 300, c);
+    std::vector<uint32_t> expected = pixels;
+    reference_fill(expected, W, H, 10, 10, c);
+    Filling::RecursiveFloodFill(fb, 10, 10, c);
+    assert(pixels == expected);
+    assert(fb.getPixel(700, 500) == WHITE); // inside the circle is untouched
+}
+
+void test_recursive_fill_matches_reference() {
+    const int W = 128, H = 128;
+    COLORREF c = RGB(0, 128, 0);
+    std::vector<uint32_t> pixels(W * H, FramebufferSink::ToPixel(WHITE));
+    FramebufferSink fb(pixels.data(), W, H);
+    draw_test_outline(fb, c);
+    std::vector<uint32_t> expected = pixels;
+    reference_fill(expected, W, H, 60, 100, c);
+    Filling::RecursiveFloodFill(fb, 60, 100, c);
+    assert(pixels == expected);
+    // Explicit bounds clip the fill
+    std::vector<uint32_t> clipped(W * H, FramebufferSink::ToPixel(WHITE));
+    FramebufferSink fbClipped(clipped.data(), W, H);
+    Filling::RecursiveFloodFill(fbClipped, 50, 50, c, RECT{40, 40, 60, 70});
+    assert(fbClipped.getPixel(40, 40) == c && fbClipped.getPixel(59, 69) == c);
+    assert(fbClipped.getPixel(39, 50) == WHITE && fbClipped.getPixel(60, 50) == WHITE && fbClipped.getPixel(50, 70) == WHITE);
+}
+
+// Counts how often each pixel is written
+struct OverdrawSink {
+    int w, h;
+    std::vector<int> hits;
+    OverdrawSink(int w, int h) : w(w), h(h), hits(w * h, 0) {}
+    void setPixel(int x, int y, COLORREF) { if (x >= 0 && y >= 0 && x < w && y < h) hits[y * w + x]++; }
+    void fillSpan(int y, int x0, int x1, COLORREF c) { for (int x = x0; x <= x1; x++) setPixel(x, y, c); }
+    COLORREF getPixel(int, int) { return CLR_INVALID; }
+    RECT bounds() const { return RECT{0, 0, w, h}; }
+};
+
+void test_triangle_pixels_written_once() {
+    OverdrawSink sink(64, 64);
+    // Two triangles sharing the diagonal of a square cover it exactly once (top-left rule)
+    Filling::BarycentricFill(sink, 10, 10, 40, 10, 40, 40, RGB(0, 0, 0));
+    Filling::BarycentricFill(sink, 10, 10, 40, 40, 10, 40, RGB(0, 0, 0));
+    int covered = 0;
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) {
+            int n = sink.hits[y * 64 + x];
+            assert(n <= 1);
+            covered += n;
+            // Inside the square's left/top edges, outside its right/bottom ones
+            assert((n == 1) == (x >= 10 && x < 40 && y >= 10 && y < 40));
+        }
+    }
+    assert(covered == 30 * 30);
+}
+
+void test_triangle_tiles_match_per_pixel() {
+    const int W = 200, H = 150;
+    int tris[][6] = {{5, 5, 190, 20, 60, 140}, {100, 2, 3, 3, 50, 7}, {-50, -20, 250, 75, 10, 300}, {7, 7, 9, 8, 8, 12}};
+    for (auto& t : tris) {
+        std::vector<uint32_t> a(W * H, 0), b(W * H, 0);
+        FramebufferSink fa(a.data(), W, H), fb(b.data(), W, H);
+        CountingSink<FramebufferSink> counter(fa);
+        Filling::BarycentricFill(counter, t[0], t[1], t[2], t[3], t[4], t[5], RGB(1, 2, 3), true);
+        Filling::BarycentricFill(fb, t[0], t[1], t[2], t[3], t[4], t[5], RGB(1, 2, 3), false);
+        assert(a == b);
+        // Cost follows the covered area: one write per covered pixel, none off-canvas
+        size_t covered = 0;
+        for (uint32_t p : a) covered += p != 0;
+        assert(counter.writes == covered);
+        assert(counter.reads == 0);
+    }
+}
+
+void test_nonconvex_fill_rules() {
+    const int W = 100, H = 100;
+    // Pentagram: the center pentagon is crossed twice, so it is a hole only under even-odd
+    std::vector<POINT> star = {{50, 5}, {77, 90}, {5, 35}, {95, 35}, {23, 90}};
+    std::vector<uint32_t> evenOdd(W * H, 0), nonZero(W * H, 0);
+    FramebufferSink fe(evenOdd.data(), W, H), fn(nonZero.data(), W, H);
+    Filling::NonConvexFill(fe, star, RGB(255, 0, 0), FILL_RULE_EVEN_ODD);
+    Filling::NonConvexFill(fn, star, RGB(255, 0, 0), FILL_RULE_NONZERO);
+    assert(fe.getPixel(50, 50) != RGB(255, 0, 0));
+    assert(fn.getPixel(50, 50) == RGB(255, 0, 0));
+    // The points of the star are filled under both rules
+    assert(fe.getPixel(50, 20) == RGB(255, 0, 0) && fn.getPixel(50, 20) == RGB(255, 0, 0));
+    assert(fe.getPixel(20, 38) == RGB(255, 0, 0) && fn.getPixel(20, 38) == RGB(255, 0, 0));
+}
+
+void test_nonconvex_fill_many_vertices() {
+    // A 100k-vertex circle, filled as one polygon
+    const int W = 512, H = 512, N = 100000;
+    std::vector<POINT> circle(N);
+    for (int i = 0; i < N; i++) {
+        double a = 2 * 3.14159265358979 * i / N;
+        circle[i] = POINT{(LONG)round(256 + 200 * cos(a)), (LONG)round(256 + 200 * sin(a))};
+    }
+    std::vector<uint32_t> pixels(W * H, 0);
+    FramebufferSink fb(pixels.data(), W, H);
+    Filling::NonConvexFill(fb, circle, RGB(0, 0, 255), FILL_RULE_NONZERO);
+    size_t filled = 0;
+    for (uint32_t p : pixels) filled += p != 0;
+    double area = 3.14159265358979 * 200 * 200;
+    assert(filled > area * 0.98 && filled < area * 1.02);
+    assert(fb.getPixel(256, 256) == RGB(0, 0, 255));
+    assert(fb.getPixel(256, 30) == RGB(0, 0, 0));
+}
+
+void test_scanline_fills_beyond_800_rows() {
+    // Tables follow the polygon, so rows past the old 800-row limit and off-canvas rows are fine
+    const int W = 300, H = 2000;
+    std::vector<POINT> quad = {{50, 1500}, {250, 1500}, {250, 1900}, {50, 1900}};
+    std::vector<POINT> offCanvas = {{10, -500}, {100, -500}, {100, 20}, {10, 20}};
+    for (int convex = 0; convex < 2; convex++) {
+        std::vector<uint32_t> pixels(W * H, 0);
+        FramebufferSink fb(pixels.data(), W, H);
+        CountingSink<FramebufferSink> counter(fb);
+        if (convex) {
+            Filling::ConvexFill(counter, quad, RGB(0, 255, 0));
+            Filling::ConvexFill(counter, offCanvas, RGB(0, 255, 0));
+        } else {
+            Filling::NonConvexFill(counter, quad, RGB(0, 255, 0));
+            Filling::NonConvexFill(counter, offCanvas, RGB(0, 255, 0));
+        }
+        assert(fb.getPixel(150, 1700) == RGB(0, 255, 0));
+        assert(fb.getPixel(150, 1400) == RGB(0, 0, 0));
+        assert(fb.getPixel(50, 0) == RGB(0, 255, 0));
+        assert(fb.getPixel(50, 19) == RGB(0, 255, 0));
+        assert(fb.getPixel(50, 21) == RGB(0, 0, 0));
+        // Only visible rows are emitted, one span per row
+        assert(counter.writes < (size_t)(201 * 400 + 91 * 20 + 1000));
+        assert(counter.spans == 400 + 20);
+        assert(counter.reads == 0);
+    }
+}
+
+void test_circle_quarter_sector() {
+    const int W = 300, H = 300, R = 120;
+    for (int quarter = 1; quarter <= 4; quarter++) {
+        OverdrawSink sink(W, H);
+        Filling::FillCircleQuarter(sink, 150, 150, R, quarter, RGB(0, 0, 0));
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int dx = x - 150, dy = 150 - y; // y up, like the quarter numbering
+                bool side = (quarter == 1 && dx >= 0 && dy >= 0) || (quarter == 2 && dx <= 0 && dy >= 0) ||
+                            (quarter == 3 && dx <= 0 && dy <= 0) || (quarter == 4 && dx >= 0 && dy <= 0);
+                bool expected = side && dx * dx + dy * dy <= R * R;
+                // Every pixel of the sector exactly once, nothing outside it
+                assert(sink.hits[y * W + x] == (expected ? 1 : 0));
+            }
+        }
+    }
+}
+
+void test_small_circle_stamps_match_circles() {
+    const int W = 300, H = 300;
+    for (int quarter = 1; quarter <= 4; quarter++) {
+        // Reference: one BresenhamCircle per small circle, as before the stamps
+        std::vector<uint32_t> expected(W * H, 0);
+        FramebufferSink fe(expected.data(), W, H);
+        const int R = 130, step = 2 * Filling::SMALL_CIRCLE_MAX_RADIUS;
+        for (int y = -R; y <= R; y += step) {
+            for (int x = -R; x <= R; x += step) {
+                if (x * x + y * y > R * R) continue;
+                bool in = (quarter == 1 && x >= 0 && y <= 0) || (quarter == 2 && x <= 0 && y <= 0) ||
+                          (quarter == 3 && x <= 0 && y >= 0) || (quarter == 4 && x >= 0 && y >= 0);
+                if (!in) continue;
+                int r = (int)(1 + (1.0 - sqrt((double)(x * x + y * y)) / R) * (Filling::SMALL_CIRCLE_MAX_RADIUS - 1));
+                SecondDegreeCurve::BresenhamCircle(fe, 150 + x, 150 + y, r < 1 ? 1 : r, RGB(9, 9, 9));
+            }
+        }
+        for (int batch = 0; batch < 2; batch++) {
+            std::vector<uint32_t> pixels(W * H, 0);
+            FramebufferSink fb(pixels.data(), W, H);
+            CountingSink<FramebufferSink> counter(fb);
+            Filling::FillQuarterWithSmallCircles(counter, 150, 150, R, quarter, RGB(9, 9, 9), batch == 1);
+            assert(pixels == expected);
+            assert(counter.reads == 0);
+        }
+    }
+}
+
+// Pixels of `full` inside [left, right] x [top, bottom], the rest cleared
+static std::vector<uint32_t> clip_to(const std::vector<uint32_t>& full, int W, int left, int top, int right, int bottom) {
+    std::vector<uint32_t> out(full.size(), 0);
+    for (int y = top; y <= bottom; y++)
+        for (int x = left; x <= right; x++)
+            out[y * W + x] = full[y * W + x];
+    return out;
+}
+
+void test_wave_patterns_match_curves() {
+    const int W = 400, H = 400;
+    const int L = Filling::WAVE_LENGTH, A = Filling::WAVE_HEIGHT;
+    const int corners[][2] = {{20, 20}, {37, 61}, {101, 13}};
+    for (const auto& corner : corners) {
+        int left = corner[0], top = corner[1], right = left + 233, bottom = top + 171;
+
+        // Reference: one BezierCurve per period, clipped to the rectangle afterwards
+        std::vector<uint32_t> curves(W * H, 0);
+        FramebufferSink fc(curves.data(), W, H);
+        for (int y = top; y <= bottom; y += 6)
+            for (int x = left; x < right; x += L)
+                ThirdDegreeCurve::BezierCurve(fc, x, y, x + L / 4, y - A, x + 3 * L / 4, y + A, x + L, y, RGB(4, 4, 4));
+        std::vector<uint32_t> pixels(W * H, 0);
+        FramebufferSink fb(pixels.data(), W, H);
+        CountingSink<FramebufferSink> counter(fb);
+        Filling::FillRectangleWithBezierWaves(counter, left, top, right, bottom, RGB(4, 4, 4));
+        assert(pixels == clip_to(curves, W, left, top, right, bottom));
+        assert(counter.reads == 0);
+
+        int size = 171;
+        std::fill(curves.begin(), curves.end(), 0);
+        for (int x = left; x <= left + size; x += 6)
+            for (int y = top; y < top + size; y += L)
+                ThirdDegreeCurve::HermiteCurve(fc, x, y, A, 0, x, y + L, -A, 0, RGB(4, 4, 4));
+        std::fill(pixels.begin(), pixels.end(), 0);
+        Filling::FillSquareWithVerticalHermiteWaves(fb, left, top, size, RGB(4, 4, 4));
+        assert(pixels == clip_to(curves, W, left, top, left + size, top + size));
+    }
+
+    // Stamps stay inside the sink's clip rectangle
+    std::vector<uint32_t> pixels(W * H, 0);
+    FramebufferSink fb(pixels.data(), W, H);
+    fb.setClip(50, 50, 120, 110);
+    Filling::FillRectangleWithBezierWaves(fb, 10, 10, 300, 300, RGB(4, 4, 4));
+    int inside = 0;
+    for (int y = 0; y < H; y++)
+        for (int x = 0; x < W; x++)
+            if (pixels[y * W + x]) {
+                assert(fb.contains(x, y));
+                inside++;
+            }
+    assert(inside > 0);
+}
+
+int main() {
+    test_span_mask_from_pixels();
+    test_flood_fill_spans_are_replayed();
+    test_scanline_fill_matches_reference();
+    test_scanline_fill_stays_in_bounds();
+    test_fill_reaching_edge_is_not_cached();
+    test_recursive_fill_matches_reference();
+    test_recursive_fill_large_region();
+    test_triangle_pixels_written_once();
+    test_triangle_tiles_match_per_pixel();
+    test_nonconvex_fill_rules();
+    test_nonconvex_fill_many_vertices();
+    test_scanline_fills_beyond_800_rows();
+    test_circle_quarter_sector();
+    test_small_circle_stamps_match_circles();
+    test_wave_patterns_match_curves();
+    std::cout << "All Filling unit tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "../include/layer_bounds.h"
+#include "../include/layer_renderer.h"
+#include "../include/pixel_sink.h"
+#include "../src/common.cpp"
+#include "../src/circle_cache.cpp"
+#include "../src/curves_third_degree.cpp"
+#include "../src/cardinal_spline.cpp"
+#include "../src/filling.cpp"
+#include "../src/layer_bounds.cpp"
+#include "../src/span_mask.cpp"
+#include <cassert>
+#include <vector>
+#include <iostream>
+
+static const COLORREF WHITE = RGB(255, 255, 255);
+static const RECT CANVAS = {0, 0, 400, 400};
+
+// Renders layers[index] on a white canvas and checks that every touched pixel lies in its box
+void assert_layer_inside_box(const std::vector<Layer>& layers, size_t index) {
+    const int W = 400, H = 400;
+    std::vector<uint32_t> pixels(W * H, FramebufferSink::ToPixel(WHITE));
+    FramebufferSink fb(pixels.data(), W, H);
+    for (size_t i = 0; i < index; ++i) LayerRenderer::RenderLayer(fb, layers, layers[i]);
+    std::vector<uint32_t> before = pixels;
+    LayerRenderer::RenderLayer(fb, layers, layers[index]);
+    RECT box = LayerBounds::Of(layers, index, CANVAS);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            if (pixels[y * W + x] != before[y * W + x]) {
+                assert(LayerBounds::ContainsPoint(box, POINT{x, y}));
+            }
+        }
+    }
+}
+
+void test_shapes_stay_inside_their_boxes() {
+    COLORREF c = RGB(0, 0, 0);
+    std::vector<Layer> layers = {
+        Layer{LayerLine{{20, 30}, {180, 90}, c, 0}},
+        Layer{LayerCircle{{200, 200}, 50, c, 0}},
+        Layer{LayerEllipse{{200, 200}, 80, 30, c, 0}},
+        Layer{LayerRect{{50, 50}, {150, 120}, c}},
+        Layer{LayerPolygon{{{100, 250}, {180, 260}, {150, 340}, {100, 250}}, c}},
+        Layer{LayerQuarterCircleFilling{{200, 200}, 60, 3, c}},
+        Layer{LayerRectangleBezierWaves{{50, 50}, {150, 120}, c}},
+        Layer{LayerCircleQuarter{{200, 200}, 60, 2, c}},
+        Layer{LayerSquareHermiteWaves{{220, 220}, 100, c}},
+        Layer{LayerBezierCurve{{10, 390}, {100, 200}, {300, 390}, {390, 250}, c, BEZIER_FORWARD_DIFFERENCES}},
+        Layer{LayerBezierCurve{{20, 100}, {320, 100}, {320, 100}, {120, 100}, c, BEZIER_FORWARD_DIFFERENCES}}, // collinear, turns back past p3
+        Layer{LayerBezierCurve{{10, 390}, {100, 200}, {300, 390}, {390, 250}, c, BEZIER_FLATTENED}},
+        Layer{LayerBezierCurve{{20, 100}, {320, 100}, {320, 100}, {120, 100}, c, BEZIER_FLATTENED}},
+        Layer{LayerCardinalSpline{{50, 300, 120, 200, 200, 350, 300, 220, 380, 300}, c}},
+    };
+    for (size_t i = 0; i < layers.size(); ++i) {
+        std::vector<Layer> single = {layers[i]};
+        assert_layer_inside_box(single, 0);
+    }
+    // Wave fills are clipped to their rectangle, so their box is the rectangle's
+    RECT waves = LayerBounds::OfShape(LayerRectangleBezierWaves{{50, 50}, {150, 120}, c});
+    RECT rect = LayerBounds::OfShape(LayerRect{{50, 50}, {150, 120}, c});
+    assert(waves.left == rect.left && waves.top == rect.top && waves.right == rect.right && waves.bottom == rect.bottom);
+}
+
+void test_fill_bounded_by_target() {
+    COLORREF c = RGB(255, 0, 0);
+    std::vector<Layer> layers = {
+        Layer{LayerRect{{50, 50}, {150, 120}, c}},
+        Layer{LayerFill{{100, 80}, c, 0, 0, nullptr, std::nullopt}},
+    };
+    RECT target = LayerBounds::Of(layers, 0, CANVAS);
+    assert(LayerBounds::Contains(target, LayerBounds::Of(layers, 1, CANVAS)));
+    assert_layer_inside_box(layers, 1);
+    // A seed outside the shape can flood the whole canvas
+    layers[1] = Layer{LayerFill{{300, 300}, c, 0, 0, nullptr, std::nullopt}};
+    assert(LayerBounds::Contains(LayerBounds::Of(layers, 1, CANVAS), RECT{0, 0, 10000, 10000}));
+
+    // Inside the box of a circle or an ellipse is not inside the shape: a seed in a box corner floods the canvas
+    const LayerShape round[] = {LayerCircle{{200, 200}, 50, c, CIRCLE_MIDPOINT}, LayerEllipse{{200, 200}, 80, 30, c, ELLIPSE_MIDPOINT}};
+    for (const LayerShape& shape : round) {
+        RECT box = LayerBounds::OfShape(shape);
+        std::vector<Layer> corner = {Layer{shape}, Layer{LayerFill{{box.left + 2, box.top + 2}, c, FILL_NONRECURSIVE_FLOOD, 0, nullptr, std::nullopt}}};
+        assert(LayerBounds::Contains(LayerBounds::Of(corner, 1, CANVAS), RECT{0, 0, 10000, 10000}));
+        assert_layer_inside_box(corner, 1);
+        std::vector<Layer> center = {Layer{shape}, Layer{LayerFill{{200, 200}, c, FILL_NONRECURSIVE_FLOOD, 0, nullptr, std::nullopt}}};
+        assert(LayerBounds::Contains(box, LayerBounds::Of(center, 1, CANVAS)));
+        assert_layer_inside_box(center, 1);
+        // Once rendered, the box is the recorded flood itself
+        RECT recorded = LayerBounds::Of(center, 1, CANVAS);
+        assert(std::get<LayerFill>(center[1].shape).spans && LayerBounds::Contains(box, recorded));
+        // A fill of another color is not stopped by the outline
+        std::vector<Layer> other = {Layer{shape}, Layer{LayerFill{{200, 200}, RGB(0, 0, 255), FILL_NONRECURSIVE_FLOOD, 0, nullptr, std::nullopt}}};
+        assert(LayerBounds::Contains(LayerBounds::Of(other, 1, CANVAS), RECT{0, 0, 10000, 10000}));
+    }
+}
+
+void test_fill_extent_cut_to_canvas() {
+    COLORREF c = RGB(255, 0, 0);
+    // Only the canvas part of a huge target is drawn to follow the flood
+    std::vector<Layer> huge = {
+        Layer{LayerCircle{{200, 200}, 30000, c, CIRCLE_MIDPOINT}},
+        Layer{LayerFill{{200, 200}, c, FILL_NONRECURSIVE_FLOOD, 0, nullptr, std::nullopt}},
+    };
+    assert(LayerBounds::Contains(LayerBounds::Of(huge, 1, CANVAS), CANVAS));
+    // A seed off the canvas is not followed
+    std::vector<Layer> away = {
+        Layer{LayerRect{{50, 50}, {150, 120}, c}},
+        Layer{LayerFill{{1000, 1000}, c, FILL_NONRECURSIVE_FLOOD, 0, nullptr, std::nullopt}},
+    };
+    assert(LayerBounds::Contains(LayerBounds::Of(away, 1, CANVAS), RECT{0, 0, 10000, 10000}));
+
+    // The answer is worked out once and kept until an earlier layer changes
+    std::vector<Layer> layers = {
+        Layer{LayerRect{{50, 50}, {150, 120}, c}},
+        Layer{LayerFill{{100, 80}, c, FILL_NONRECURSIVE_FLOOD, 0, nullptr, std::nullopt}},
+    };
+    RECT target = LayerBounds::Of(layers, 0, CANVAS);
+    RECT first = LayerBounds::Of(layers, 1, CANVAS);
+    const LayerFill& fill = std::get<LayerFill>(layers[1].shape);
+    assert(fill.extent && LayerBounds::Contains(target, first));
+    std::get<LayerRect>(layers[0].shape).p2 = POINT{90, 70}; // the seed is now outside
+    assert(LayerBounds::Contains(target, LayerBounds::Of(layers, 1, CANVAS)));
+    LayerRenderer::InvalidateFillCaches(layers, 0);
+    assert(!fill.extent);
+    assert(LayerBounds::Contains(LayerBounds::Of(layers, 1, CANVAS), RECT{0, 0, 10000, 10000}));
+}
+
+void test_rect_operations() {
+    RECT a = {0, 0, 10, 10};
+    RECT b = {5, 5, 20, 20};
+    RECT u = LayerBounds::Union(a, b);
+    assert(u.left == 0 && u.top == 0 && u.right == 20 && u.bottom == 20);
+    RECT i = LayerBounds::Intersection(a, b);
+    assert(i.left == 5 && i.top == 5 && i.right == 10 && i.bottom == 10);
+    assert(LayerBounds::IsEmpty(LayerBounds::Intersection(a, RECT{10, 0, 20, 10})));
+    assert(!LayerBounds::Intersects(a, LayerBounds::Empty));
+    RECT e = LayerBounds::Union(LayerBounds::Empty, a);
+    assert(e.left == 0 && e.right == 10);
+}
+
+int main() {
+    test_rect_operations();
+    test_shapes_stay_inside_their_boxes();
+    test_fill_bounded_by_target();
+    test_fill_extent_cut_to_canvas();
+    std::cout << "All LayerBounds unit tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "../include/lines.h"
+#include "../include/pixel_sink.h"
+#include "../src/common.cpp"
+#include <cassert>
+#include <vector>
+#include <iostream>
+
+void test_framebuffer_sink() {
+    std::vector<uint32_t> pixels(4 * 3, 0);
+    FramebufferSink fb(pixels.data(), 4, 3);
+    fb.setPixel(1, 2, RGB(255, 0, 0));
+    assert(pixels[2 * 4 + 1] == 0x00FF0000); // stored as 0x00RRGGBB
+    assert(fb.getPixel(1, 2) == RGB(255, 0, 0));
+    // Out-of-range writes are dropped, reads report CLR_INVALID
+    fb.setPixel(-1, 0, RGB(1, 2, 3));
+    fb.setPixel(4, 0, RGB(1, 2, 3));
+    assert(fb.getPixel(4, 0) == CLR_INVALID);
+    assert(fb.getPixel(0, -1) == CLR_INVALID);
+    // A clip rectangle behaves like the edge of the buffer
+    fb.setClip(1, 1, 3, 3);
+    fb.setPixel(0, 0, RGB(1, 2, 3));
+    assert(pixels[0] == 0);
+    assert(fb.getPixel(0, 0) == CLR_INVALID);
+    assert(fb.getPixel(1, 2) == RGB(255, 0, 0));
+    fb.resetClip();
+    assert(fb.getPixel(0, 0) == RGB(0, 0, 0));
+    // Spans are clipped like single pixels
+    fb.fillSpan(1, -5, 2, RGB(0, 255, 0));
+    assert(pixels[1 * 4 + 0] == 0x0000FF00 && pixels[1 * 4 + 2] == 0x0000FF00 && pixels[1 * 4 + 3] == 0);
+    fb.fillSpan(7, 0, 3, RGB(0, 255, 0)); // row outside the buffer
+}
+
+void test_line_bresenham_framebuffer() {
+    const int W = 16, H = 16;
+    std::vector<uint32_t> pixels(W * H, 0);
+    FramebufferSink fb(pixels.data(), W, H);
+    Lines::LineBresenhamDDA(fb, 0, 0, 10, 5, RGB(0, 0, 255));
+    assert(fb.getPixel(0, 0) == RGB(0, 0, 255));
+    assert(fb.getPixel(10, 5) == RGB(0, 0, 255));
+    // One pixel per column for an x-major line
+    for (int x = 0; x <= 10; x++) {
+        int count = 0;
+        for (int y = 0; y < H; y++) count += fb.getPixel(x, y) == RGB(0, 0, 255);
+        assert(count == 1);
+    }
+}
+
+void test_counting_sink() {
+    std::vector<uint32_t> pixels(32 * 32, 0);
+    FramebufferSink fb(pixels.data(), 32, 32);
+    CountingSink<FramebufferSink> counter(fb);
+    Lines::LineBresenhamDDA(counter, 2, 3, 2, 20, RGB(0, 0, 0));
+    assert(counter.writes == 18);
+    assert(counter.reads == 0);
+}
+
+int main() {
+    test_framebuffer_sink();
+    test_line_bresenham_framebuffer();
+    test_counting_sink();
+    std::cout << "All Lines unit tests passed!\n";
+    return 0;
+}
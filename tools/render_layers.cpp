@@ -0,0 +1,98 @@
+// Headless batch renderer: rasterizes saved layer files to PPM/BMP without a window.
+//
+// Usage: render_layers [-w width] [-h height] [-f ppm|bmp] [-o output] layers.txt...
+//   Each input is written next to itself with the format's extension, unless -o is given
+//   (single input only). "-o -" streams the image to stdout.
+#include "../include/platform.h"
+#include "../include/pixel_sink.h"
+#include "../include/layer.h"
+#include "../include/layer_renderer.h"
+#include "../include/storage.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+static void usage() {
+    std::cerr << "Usage: render_layers [-w width] [-h height] [-f ppm|bmp] [-o output|-] layers.txt...\n";
+}
+
+// Replace the extension of a layers file with the image format's extension
+static std::string outputPathFor(const std::string& input, const std::string& format) {
+    size_t slash = input.find_last_of("/\\");
+    size_t dot = input.find_last_of('.');
+    std::string stem = (dot != std::string::npos && (slash == std::string::npos || dot > slash)) ? input.substr(0, dot) : input;
+    return stem + "." + format;
+}
+
+int main(int argc, char** argv) {
+    int width = 800;
+    int height = 600;
+    std::string format = "ppm";
+    std::string output;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "-w" || arg == "-h" || arg == "-f" || arg == "-o") && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (arg == "-w") width = std::atoi(value.c_str());
+            else if (arg == "-h") height = std::atoi(value.c_str());
+            else if (arg == "-f") format = value;
+            else output = value;
+        } else if (!arg.empty() && arg[0] == '-') {
+            usage();
+            return 2;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty() || width <= 0 || height <= 0 || (format != "ppm" && format != "bmp") ||
+        (!output.empty() && inputs.size() > 1)) {
+        usage();
+        return 2;
+    }
+
+    // One framebuffer is reused for every scene in the batch
+    std::vector<uint32_t> pixels((size_t)width * height);
+    FramebufferSink fb(pixels.data(), width, height);
+    std::vector<Layer> layers;
+    int failures = 0;
+
+    for (const std::string& input : inputs) {
+        if (!Storage::loadLayersFromFile(layers, input)) {
+            ++failures;
+            continue;
+        }
+        std::fill(pixels.begin(), pixels.end(), FramebufferSink::ToPixel(RGB(255, 255, 255)));
+        LayerRenderer::RenderLayers(fb, layers);
+
+        bool bmp = format == "bmp";
+        bool ok;
+        if (output == "-") {
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+            ok = bmp ? Storage::writeBMP(std::cout, fb) : Storage::writePPM(std::cout, fb);
+            std::cout.flush();
+        } else {
+            std::string path = output.empty() ? outputPathFor(input, format) : output;
+            std::ofstream outFile(path, std::ios::binary);
+            if (!outFile.is_open()) {
+                std::cerr << "Error opening file: " << path << "\n";
+                ok = false;
+            } else {
+                ok = bmp ? Storage::writeBMP(outFile, fb) : Storage::writePPM(outFile, fb);
+            }
+        }
+        if (!ok) ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}